@@ -0,0 +1,158 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "MyStateSwitch.h"
+#include "SMyStateSwitch.h"
+#include "MyStateSwitchSlot.h"
+#include "Layout/ArrangedChildren.h"
+
+#define LOCTEXT_NAMESPACE "UMG"
+
+UMyStateSwitch::UMyStateSwitch(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+	bIsVariable = true;
+	StateIndex = 0;
+	NumStates = 2;
+	IsFocusable = true;
+	SMyStateSwitch::FArguments Defaults;
+	Visibility = UWidget::ConvertRuntimeToSerializedVisibility(Defaults._Visibility.Get());
+}
+
+void UMyStateSwitch::ReleaseSlateResources(bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+	MySwitch.Reset();
+}
+
+void UMyStateSwitch::SynchronizeProperties()
+{
+	Super::SynchronizeProperties();
+
+	if (MySwitch.IsValid())
+	{
+		MySwitch->SetNumStates(NumStates);
+		MySwitch->SetCycleOrder(CycleOrder);
+		MySwitch->SetStateIndex(PROPERTY_BINDING(int32, StateIndex));
+	}
+}
+
+#if WITH_EDITOR
+const FText UMyStateSwitch::GetPaletteCategory()
+{
+	return LOCTEXT("Custom Control", "Custom Control");
+}
+#endif
+
+TSharedRef<SWidget> UMyStateSwitch::RebuildWidget()
+{
+	MySwitch = SNew(SMyStateSwitch)
+		.StateIndex(StateIndex)
+		.NumStates(NumStates)
+		.CycleOrder(CycleOrder)
+		.IsFocusable(IsFocusable)
+		.OnStateChanged(BIND_UOBJECT_DELEGATE(FOnStateSwitchChanged, SlateOnStateChanged));
+
+	for (UPanelSlot* slot : Slots)
+	{
+		if (UMyStateSwitchSlot* SwitchSlot = Cast<UMyStateSwitchSlot>(slot))
+		{
+			SwitchSlot->Parent = this;
+			SwitchSlot->BuildSlot(MySwitch.ToSharedRef());
+		}
+	}
+
+	return MySwitch.ToSharedRef();
+}
+
+UClass* UMyStateSwitch::GetSlotClass() const
+{
+	return UMyStateSwitchSlot::StaticClass();
+}
+
+void UMyStateSwitch::OnSlotAdded(UPanelSlot* InSlot)
+{
+	if (MySwitch.IsValid())
+	{
+		CastChecked<UMyStateSwitchSlot>(InSlot)->BuildSlot(MySwitch.ToSharedRef());
+	}
+}
+
+void UMyStateSwitch::OnSlotRemoved(UPanelSlot* InSlot)
+{
+	// By slot rather than by widget, a slot without content shows the null widget and its content has no cached widget.
+	const SMyStateSwitch::FSlot* SlateSlot = CastChecked<UMyStateSwitchSlot>(InSlot)->GetSlateSlot();
+	if (MySwitch.IsValid() && SlateSlot != nullptr)
+	{
+		MySwitch->RemoveSlot(SlateSlot);
+	}
+}
+
+void UMyStateSwitch::SetStateIndex(int32 InStateIndex)
+{
+	StateIndex = InStateIndex;
+	if (MySwitch.IsValid())
+	{
+		MySwitch->SetStateIndex(PROPERTY_BINDING(int32, StateIndex));
+	}
+}
+
+int32 UMyStateSwitch::GetStateIndex() const
+{
+	if (MySwitch.IsValid())
+	{
+		return MySwitch->GetStateIndex();
+	}
+
+	return StateIndex;
+}
+
+void UMyStateSwitch::SetCycleOrder(const TArray<int32>& InCycleOrder)
+{
+	CycleOrder = InCycleOrder;
+	if (MySwitch.IsValid())
+	{
+		MySwitch->SetCycleOrder(CycleOrder);
+	}
+}
+
+TSharedPtr<SMyStateSwitch> UMyStateSwitch::GetSwitchWidget() const
+{
+	return MySwitch;
+}
+
+bool UMyStateSwitch::GetGeometryForSlot(UMyStateSwitchSlot* InSlot, FGeometry& ArrangedGeometry) const
+{
+	if (InSlot->Content == nullptr)
+	{
+		return false;
+	}
+
+	TSharedPtr<SMyStateSwitch> Switch = GetSwitchWidget();
+	if (Switch.IsValid())
+	{
+		FArrangedChildren ArrangedChildren(EVisibility::All);
+		Switch->ArrangeChildren(Switch->GetCachedGeometry(), ArrangedChildren);
+
+		for (int32 ChildIndex = 0; ChildIndex < ArrangedChildren.Num(); ChildIndex++)
+		{
+			if (ArrangedChildren[ChildIndex].Widget == InSlot->Content->GetCachedWidget())
+			{
+				ArrangedGeometry = ArrangedChildren[ChildIndex].Geometry;
+				return true;
+			}
+		}
+	}
+
+	return false;
+}
+
+void UMyStateSwitch::SlateOnStateChanged(int32 NewState)
+{
+	const int32 Last = StateIndex;
+	StateIndex = NewState;
+
+	OnStateChanged.Broadcast(Last, NewState);
+}
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,83 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Components/PanelWidget.h"
+#include "SMyStateSwitch.h"
+#include "MyStateSwitch.generated.h"
+
+class SMyStateSwitch;
+class UMyStateSwitchSlot;
+class SWidget;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnSwitchStateChanged, int32, LastState, int32, NewState);
+/**
+ * A toggle with any number of states. Each slot is shown in one state or in all of them.
+ */
+UCLASS()
+class UMGEXTENTIONSAMPLE_API UMyStateSwitch : public UPanelWidget
+{
+	GENERATED_UCLASS_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Appearance", meta = (ClampMin = "0"))
+	int32 StateIndex;
+
+	UPROPERTY()
+	FGetInt32 StateIndexDelegate;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance", meta = (ClampMin = "1"))
+	int32 NumStates;
+
+	/** Order the states are cycled through on click or accept. Empty cycles 0 .. NumStates - 1 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interaction")
+	TArray<int32> CycleOrder;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interaction")
+	bool IsFocusable;
+
+	UPROPERTY(BlueprintAssignable, Category = "Switch|Event")
+	FOnSwitchStateChanged OnStateChanged;
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "Switch")
+	void SetStateIndex(int32 InStateIndex);
+
+	UFUNCTION(BlueprintCallable, Category = "Switch")
+	int32 GetStateIndex() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Switch")
+	void SetCycleOrder(const TArray<int32>& InCycleOrder);
+
+	// Begin UVisual Interface
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+	// End UVisual Interface
+
+	// Begin UWidget
+	virtual void SynchronizeProperties() override;
+#if WITH_EDITOR
+	virtual const FText GetPaletteCategory() override;
+#endif
+	// End UWidget
+
+	TSharedPtr<SMyStateSwitch> GetSwitchWidget() const;
+	bool GetGeometryForSlot(UMyStateSwitchSlot* InSlot, FGeometry& ArrangedGeometry) const;
+protected:
+	// Begin UWidget
+	virtual TSharedRef<SWidget> RebuildWidget() override;
+	// End UWidget
+
+	// Begin UPanelWidget
+	virtual UClass* GetSlotClass() const override;
+	virtual void OnSlotAdded(UPanelSlot* InSlot) override;
+	virtual void OnSlotRemoved(UPanelSlot* InSlot) override;
+	// End UPanelWidget
+
+	void SlateOnStateChanged(int32 NewState);
+
+protected:
+	TSharedPtr<SMyStateSwitch> MySwitch;
+
+	PROPERTY_BINDING_IMPLEMENTATION(int32, StateIndex)
+};
@@ -0,0 +1,295 @@
+#include "MyStateSwitchSlot.h"
+#include "SMyStateSwitch.h"
+#include "MyStateSwitch.h"
+
+/////////////////////////////////////////////////////
+// UMyStateSwitchSlot
+
+UMyStateSwitchSlot::UMyStateSwitchSlot(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, Slot(nullptr)
+	, bSlotSynced(false)
+{
+	LayoutData.Offsets = FMargin(0, 0, 100, 30);
+	LayoutData.Anchors = FAnchors(0.0f, 0.0f);
+	LayoutData.Alignment = FVector2D(0.0f, 0.0f);
+	bAutoSize = false;
+	ZOrder = 0;
+	StateIndex = INDEX_NONE;
+}
+
+void UMyStateSwitchSlot::ReleaseSlateResources(bool bReleaseChildren)
+{
+	Super::ReleaseSlateResources(bReleaseChildren);
+
+	Slot = nullptr;
+	OwningSwitch.Reset();
+	bSlotSynced = false;
+}
+
+void UMyStateSwitchSlot::BuildSlot(TSharedRef<SMyStateSwitch> Switch)
+{
+	OwningSwitch = Switch;
+	bSlotSynced = false;
+	Slot = &Switch->AddSlot()
+		[
+			Content == nullptr ? SNullWidget::NullWidget : Content->TakeWidget()
+		];
+
+	SynchronizeProperties();
+}
+
+#if WITH_EDITOR
+
+bool UMyStateSwitchSlot::NudgeByDesigner(const FVector2D& NudgeDirection, const TOptional<int32>& GridSnapSize)
+{
+	const FVector2D OldPosition = GetPosition();
+	FVector2D NewPosition = OldPosition + NudgeDirection;
+
+	// Determine the new position aligned to the grid.
+	if (GridSnapSize.IsSet())
+	{
+		if (NudgeDirection.X != 0)
+		{
+			NewPosition.X = ((int32)NewPosition.X) - (((int32)NewPosition.X) % GridSnapSize.GetValue());
+		}
+		if (NudgeDirection.Y != 0)
+		{
+			NewPosition.Y = ((int32)NewPosition.Y) - (((int32)NewPosition.Y) % GridSnapSize.GetValue());
+		}
+	}
+
+	if (OldPosition == NewPosition)
+	{
+		return false;
+	}
+
+	Modify();
+
+	SetPosition(NewPosition);
+
+	return true;
+}
+
+bool UMyStateSwitchSlot::DragDropPreviewByDesigner(const FVector2D& LocalCursorPosition, const TOptional<int32>& XGridSnapSize, const TOptional<int32>& YGridSnapSize)
+{
+	FVector2D NewPosition = LocalCursorPosition;
+	if (XGridSnapSize.IsSet())
+	{
+		NewPosition.X = ((int32)NewPosition.X) - (((int32)NewPosition.X) % XGridSnapSize.GetValue());
+	}
+	if (YGridSnapSize.IsSet())
+	{
+		NewPosition.Y = ((int32)NewPosition.Y) - (((int32)NewPosition.Y) % YGridSnapSize.GetValue());
+	}
+
+	// Return false and early out if there are no effective changes.
+	if (GetPosition() == NewPosition)
+	{
+		return false;
+	}
+
+	SetPosition(NewPosition);
+
+	return true;
+}
+
+void UMyStateSwitchSlot::SynchronizeFromTemplate(const UPanelSlot* const TemplateSlot)
+{
+	const ThisClass* const TemplateSwitchSlot = CastChecked<ThisClass>(TemplateSlot);
+	SetPosition(TemplateSwitchSlot->GetPosition());
+	SetSize(TemplateSwitchSlot->GetSize());
+}
+
+void UMyStateSwitchSlot::PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent)
+{
+	SynchronizeProperties();
+
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+}
+
+#endif //WITH_EDITOR
+
+void UMyStateSwitchSlot::SetLayout(const FAnchorData& InLayoutData)
+{
+	LayoutData = InLayoutData;
+
+	if (Slot)
+	{
+		PushLayout(LayoutData);
+	}
+}
+
+FAnchorData UMyStateSwitchSlot::GetLayout() const
+{
+	return LayoutData;
+}
+
+void UMyStateSwitchSlot::SetPosition(FVector2D InPosition)
+{
+	LayoutData.Offsets.Left = InPosition.X;
+	LayoutData.Offsets.Top = InPosition.Y;
+
+	if (Slot)
+	{
+		PushLayout(LayoutData);
+	}
+}
+
+FVector2D UMyStateSwitchSlot::GetPosition() const
+{
+	return FVector2D(LayoutData.Offsets.Left, LayoutData.Offsets.Top);
+}
+
+void UMyStateSwitchSlot::SetSize(FVector2D InSize)
+{
+	LayoutData.Offsets.Right = InSize.X;
+	LayoutData.Offsets.Bottom = InSize.Y;
+
+	if (Slot)
+	{
+		PushLayout(LayoutData);
+	}
+}
+
+FVector2D UMyStateSwitchSlot::GetSize() const
+{
+	return FVector2D(LayoutData.Offsets.Right, LayoutData.Offsets.Bottom);
+}
+
+void UMyStateSwitchSlot::SetAutoSize(bool InbAutoSize)
+{
+	bAutoSize = InbAutoSize;
+	if (Slot)
+	{
+		PushAutoSize(bAutoSize);
+	}
+}
+
+void UMyStateSwitchSlot::SetZOrder(int32 InZOrder)
+{
+	ZOrder = InZOrder;
+	if (Slot)
+	{
+		PushZOrder(ZOrder);
+	}
+}
+
+void UMyStateSwitchSlot::SetStateIndex(int32 InStateIndex)
+{
+	StateIndex = FMath::Max(InStateIndex, (int32)INDEX_NONE);
+	if (Slot)
+	{
+		PushStateIndex(StateIndex);
+	}
+}
+
+int32 UMyStateSwitchSlot::GetStateIndex() const
+{
+	return StateIndex;
+}
+
+void UMyStateSwitchSlot::SynchronizeProperties()
+{
+	if (Slot == nullptr)
+	{
+		return;
+	}
+
+	// Only push what changed since the last push, like UMyToggleSlot, so a sync doesn't re-sort the buckets
+	// and re-layout the switch every time.
+	const bool bForce = !bSlotSynced;
+
+	if (bForce || !(Synced.LayoutData.Offsets == LayoutData.Offsets)
+		|| Synced.LayoutData.Anchors.Minimum != LayoutData.Anchors.Minimum || Synced.LayoutData.Anchors.Maximum != LayoutData.Anchors.Maximum
+		|| Synced.LayoutData.Alignment != LayoutData.Alignment)
+	{
+		PushLayout(LayoutData);
+	}
+
+	if (bForce || Synced.bAutoSize != bAutoSize)
+	{
+		PushAutoSize(bAutoSize);
+	}
+
+	if (bForce || Synced.ZOrder != ZOrder)
+	{
+		PushZOrder(ZOrder);
+	}
+
+	StateIndex = FMath::Max(StateIndex, (int32)INDEX_NONE);
+	if (bForce || Synced.StateIndex != StateIndex)
+	{
+		PushStateIndex(StateIndex);
+	}
+
+	bSlotSynced = true;
+}
+
+TSharedPtr<SMyStateSwitch> UMyStateSwitchSlot::GetSwitchToInvalidate() const
+{
+	// The first push into a new slot is covered by the invalidation of AddSlot.
+	return bSlotSynced ? OwningSwitch.Pin() : TSharedPtr<SMyStateSwitch>();
+}
+
+void UMyStateSwitchSlot::PushLayout(const FAnchorData& InLayoutData)
+{
+	const FMargin OldOffset = Slot->OffsetAttr.Get();
+	const FAnchors OldAnchors = Slot->AnchorsAttr.Get();
+	Slot->Offset(InLayoutData.Offsets);
+	Slot->Anchors(InLayoutData.Anchors);
+	Slot->Alignment(InLayoutData.Alignment);
+	Synced.LayoutData = InLayoutData;
+
+	if (TSharedPtr<SMyStateSwitch> Switch = GetSwitchToInvalidate())
+	{
+		// Anchors decide whether offsets are sizes or margins, so the desired size may change.
+		if (OldAnchors.Minimum != InLayoutData.Anchors.Minimum || OldAnchors.Maximum != InLayoutData.Anchors.Maximum)
+		{
+			Switch->InvalidateSlotDesiredSize(*Slot);
+		}
+		else if (!(OldOffset == InLayoutData.Offsets))
+		{
+			Switch->InvalidateSlotOffset(*Slot, OldOffset);
+		}
+		else
+		{
+			Switch->InvalidateSlotGeometry(*Slot);
+		}
+	}
+}
+
+void UMyStateSwitchSlot::PushAutoSize(bool InbAutoSize)
+{
+	Slot->AutoSize(InbAutoSize);
+	Synced.bAutoSize = InbAutoSize;
+
+	if (TSharedPtr<SMyStateSwitch> Switch = GetSwitchToInvalidate())
+	{
+		Switch->InvalidateSlotDesiredSize(*Slot);
+	}
+}
+
+void UMyStateSwitchSlot::PushZOrder(int32 InZOrder)
+{
+	Slot->ZOrder(InZOrder);
+	Synced.ZOrder = InZOrder;
+
+	// Also for the first push, the switch caches its paint order.
+	if (TSharedPtr<SMyStateSwitch> Switch = OwningSwitch.Pin())
+	{
+		Switch->InvalidateSlotOrder();
+	}
+}
+
+void UMyStateSwitchSlot::PushStateIndex(int32 InStateIndex)
+{
+	Slot->State(InStateIndex);
+	Synced.StateIndex = InStateIndex;
+
+	// Also for the first push, the switch caches its state buckets.
+	if (TSharedPtr<SMyStateSwitch> Switch = OwningSwitch.Pin())
+	{
+		Switch->InvalidateSlotStates();
+	}
+}
@@ -0,0 +1,137 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/ScriptMacros.h"
+#include "Layout/Margin.h"
+#include "Widgets/Layout/Anchors.h"
+#include "SMyStateSwitch.h"
+#include "Components/PanelSlot.h"
+#include "Components/CanvasPanelSlot.h"
+#include "MyStateSwitchSlot.generated.h"
+
+
+class SMyStateSwitch;
+
+
+UCLASS()
+class UMGEXTENTIONSAMPLE_API UMyStateSwitchSlot : public UPanelSlot
+{
+	GENERATED_UCLASS_BODY()
+
+public:
+
+	/** The anchoring information for the slot */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout|Switch Slot")
+		FAnchorData LayoutData;
+
+	/** When AutoSize is true we use the widget's desired size */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout|Switch Slot", AdvancedDisplay, meta = (DisplayName = "Size To Content"))
+		bool bAutoSize;
+
+	/** The order priority this widget is rendered in.  Higher values are rendered last (and so they will appear to be on top). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout|Switch Slot")
+		int32 ZOrder;
+
+	/** The state this slot is shown in, -1 shows it in every state */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout|Switch Slot", meta = (ClampMin = "-1"))
+		int32 StateIndex;
+public:
+#if WITH_EDITOR
+	virtual bool NudgeByDesigner(const FVector2D& NudgeDirection, const TOptional<int32>& GridSnapSize) override;
+	virtual bool DragDropPreviewByDesigner(const FVector2D& LocalCursorPosition, const TOptional<int32>& XGridSnapSize, const TOptional<int32>& YGridSnapSize) override;
+	virtual void SynchronizeFromTemplate(const UPanelSlot* const TemplateSlot) override;
+#endif //WITH_EDITOR
+
+	/** Sets the layout data of the slot */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		void SetLayout(const FAnchorData& InLayoutData);
+
+	/** Gets the layout data of the slot */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		FAnchorData GetLayout() const;
+
+	/** Sets the position of the slot */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		void SetPosition(FVector2D InPosition);
+
+	/** Gets the position of the slot */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		FVector2D GetPosition() const;
+
+	/** Sets the size of the slot */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		void SetSize(FVector2D InSize);
+
+	/** Gets the size of the slot */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		FVector2D GetSize() const;
+
+	/** Sets if the slot to be auto-sized */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		void SetAutoSize(bool InbAutoSize);
+
+	/** Sets the z-order on the slot */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		void SetZOrder(int32 InZOrder);
+
+	/** Sets the state the slot is shown in, -1 for every state */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		void SetStateIndex(int32 InStateIndex);
+
+	/** Gets the state the slot is shown in, -1 for every state */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Switch Slot")
+		int32 GetStateIndex() const;
+
+public:
+
+	void BuildSlot(TSharedRef<SMyStateSwitch> Switch);
+
+	/** The Slate slot this slot was built into, null while it has no widget. */
+	const SMyStateSwitch::FSlot* GetSlateSlot() const
+	{
+		return Slot;
+	}
+
+	// UPanelSlot interface
+	virtual void SynchronizeProperties() override;
+	// End of UPanelSlot interface
+
+	virtual void ReleaseSlateResources(bool bReleaseChildren) override;
+
+#if WITH_EDITOR
+	// UObject interface
+	virtual void PostEditChangeProperty(struct FPropertyChangedEvent& PropertyChangedEvent) override;
+	// End of UObject interface
+#endif
+
+private:
+	/** The owning switch once the slot was fully synchronized, null while it is being set up. */
+	TSharedPtr<SMyStateSwitch> GetSwitchToInvalidate() const;
+
+	/** Writes to the Slate slot, remembers what was written and invalidates the switch. Slot must be valid. */
+	void PushLayout(const FAnchorData& InLayoutData);
+	void PushAutoSize(bool InbAutoSize);
+	void PushZOrder(int32 InZOrder);
+	void PushStateIndex(int32 InStateIndex);
+
+private:
+	SMyStateSwitch::FSlot* Slot;
+	TWeakPtr<SMyStateSwitch> OwningSwitch;
+
+	/** Values last written to Slot, SynchronizeProperties skips the ones that didn't change. */
+	struct FSyncedProperties
+	{
+		FAnchorData LayoutData;
+		bool bAutoSize;
+		int32 ZOrder;
+		int32 StateIndex;
+	};
+
+	FSyncedProperties Synced;
+
+	/** False until everything was pushed once to the current Slot. */
+	bool bSlotSynced;
+};
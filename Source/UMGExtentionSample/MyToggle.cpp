@@ -4,14 +4,36 @@
 #include "MyToggle.h"
 #include "SMyToggle.h"
 #include "MyToggleSlot.h"
-#include "Layout/ArrangedChildren.h"
+#include "MyToggleLayoutAsset.h"
+#include "MyToggleBuildScheduler.h"
+#include "MyToggleBitModel.h"
+#include "MyToggleTreeModel.h"
+#include "MyToggleStateQueue.h"
+#include "MyToggleStateMirror.h"
+#include "MyTogglePrefetch.h"
+#include "MyToggleNavigationGroup.h"
+#include "MyToggleNavigationGrid.h"
+#include "UObject/UObjectArray.h"
+#include "UObject/GarbageCollection.h"
 
 #define LOCTEXT_NAMESPACE "UMG"
 
+DEFINE_LOG_CATEGORY_STATIC(LogMyToggle, Log, All);
+
 UMyToggle::UMyToggle(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 {
 	bIsVariable = true;
+	OptimisticTimeout = 1.0f;
+	PendingSlotIndex = 0;
+	BoundBitIndex = INDEX_NONE;
+	BoundTreeNode = INDEX_NONE;
+	bStateMirrored = false;
+	NavigationGroup = nullptr;
+	bCheckedStateSynced = false;
+	bSyncedCheckedStateBound = false;
+	bWarnedBoundApply = false;
+	SyncedCheckedState = ECheckBoxState::Unchecked;
 	SMyToggle::FArguments Defaults;
 	Visibility = UWidget::ConvertRuntimeToSerializedVisibility(Defaults._Visibility.Get());
 }
@@ -20,14 +42,39 @@ void UMyToggle::ReleaseSlateResources(bool bReleaseChildren)
 {
 	Super::ReleaseSlateResources(bReleaseChildren);
 	MyToggle.Reset();
+	bCheckedStateSynced = false;
+
+	FMyToggleBuildScheduler::Get().Cancel(this);
+	PendingSlotIndex = 0;
 }
 
 void UMyToggle::SynchronizeProperties()
 {
 	Super::SynchronizeProperties();
 
-	if (MyToggle.IsValid())
+	if (!MyToggle.IsValid())
+		return;
+
+	// Rebuilding the attribute re-lays the toggle out, only do it when the value or the binding changed.
+	const bool bBound = CheckedStateDelegate.IsBound() && !IsDesignTime();
+	const bool bChanged = !bCheckedStateSynced
+		|| bSyncedCheckedStateBound != bBound
+		|| (bBound
+			? (SyncedCheckedStateObject.Get() != CheckedStateDelegate.GetUObject() || SyncedCheckedStateFunction != CheckedStateDelegate.GetFunctionName())
+			: SyncedCheckedState != CheckedState);
+
+	if (bChanged)
+	{
 		MyToggle->SetToggleIsChecked(PROPERTY_BINDING(ECheckBoxState, CheckedState));
+
+		bCheckedStateSynced = true;
+		bSyncedCheckedStateBound = bBound;
+		SyncedCheckedState = CheckedState;
+		SyncedCheckedStateObject = bBound ? CheckedStateDelegate.GetUObject() : nullptr;
+		SyncedCheckedStateFunction = bBound ? CheckedStateDelegate.GetFunctionName() : NAME_None;
+	}
+
+	UpdateMirroredState();
 }
 
 #if WITH_EDITOR
@@ -39,25 +86,117 @@ const FText UMyToggle::GetPaletteCategory()
 
 TSharedRef<SWidget> UMyToggle::RebuildWidget()
 {
+	// The new widget is constructed with the plain value, the next sync pushes the binding if there is one.
+	bCheckedStateSynced = true;
+	bSyncedCheckedStateBound = false;
+	SyncedCheckedState = CheckedState;
+
 	MyToggle = SNew(SMyToggle)
 		.IsToggleChecked(CheckedState)
 		.IsFocusable(IsFocusable)
-		.OnToggleCheckStateChanged(BIND_UOBJECT_DELEGATE(FOnToggleCheckStateChanged, SlateOnToggleCheckeStateChanged));
+		.OptimisticUpdate(bOptimisticUpdate)
+		.OptimisticTimeout(OptimisticTimeout)
+		.OnToggleCheckStateChanged(BIND_UOBJECT_DELEGATE(FOnToggleCheckStateChanged, SlateOnToggleCheckeStateChanged))
+		.OnPrefetchState(bPrefetchNextState && !IsDesignTime() ? BIND_UOBJECT_DELEGATE(FOnToggleStatePrefetch, SlateOnPrefetchState) : FOnToggleStatePrefetch())
+		.NavigationGrid(NavigationGroup ? NavigationGroup->GetGrid() : TSharedPtr<FMyToggleNavigationGrid>());
+
+	// The designer always shows the finished toggle.
+	const bool bDeferContent = bIncrementalConstruction && !IsDesignTime();
+	BuildToggleSlots(bDeferContent);
+
+	if (bDeferContent)
+	{
+		FMyToggleBuildScheduler::Get().Enqueue(this);
+	}
+
+	return MyToggle.ToSharedRef();
+}
+
+void UMyToggle::BuildToggleSlots(bool bDeferContent)
+{
+	MyToggle->ReserveSlots(Slots.Num() + (LayoutAsset ? LayoutAsset->Entries.Num() : 0));
+
+	if (LayoutAsset)
+	{
+		LayoutAsset->BuildSlots(MyToggle.ToSharedRef());
+	}
+
+	PendingSlotIndex = 0;
 
 	for (UPanelSlot* slot : Slots)
 	{
 		if (UMyToggleSlot* ToggleSlot = Cast<UMyToggleSlot>(slot))
 		{
 			ToggleSlot->Parent = this;
-			ToggleSlot->BuildSlot(MyToggle.ToSharedRef());
+			ToggleSlot->BuildSlot(MyToggle.ToSharedRef(), bDeferContent);
 		}
 	}
+}
 
-	return MyToggle.ToSharedRef();
+void UMyToggle::RebuildLayoutSlots()
+{
+	if (!MyToggle.IsValid())
+		return;
+
+	// Everything is built right away, pending content included.
+	FMyToggleBuildScheduler::Get().Cancel(this);
+	const bool bWasPending = IsConstructionPending();
+
+	MyToggle->ClearChildren();
+	BuildToggleSlots(false);
+
+	if (bWasPending)
+	{
+		FinishIncrementalConstruction();
+	}
 }
 
 void UMyToggle::OnWidgetRebuilt()
 {
+	if (!IsConstructionPending())
+	{
+		UpdateGCCluster();
+		OnConstructionCompleted.Broadcast();
+	}
+}
+
+bool UMyToggle::IsConstructionPending() const
+{
+	for (int32 SlotIndex = PendingSlotIndex; SlotIndex < Slots.Num(); ++SlotIndex)
+	{
+		const UMyToggleSlot* ToggleSlot = Cast<UMyToggleSlot>(Slots[SlotIndex]);
+		if (ToggleSlot && ToggleSlot->HasPendingContent())
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool UMyToggle::BuildPendingSlots(double EndTime)
+{
+	while (PendingSlotIndex < Slots.Num())
+	{
+		UMyToggleSlot* ToggleSlot = Cast<UMyToggleSlot>(Slots[PendingSlotIndex++]);
+		if (ToggleSlot && ToggleSlot->HasPendingContent())
+		{
+			ToggleSlot->BuildPendingContent();
+
+			if (FPlatformTime::Seconds() >= EndTime)
+			{
+				break;
+			}
+		}
+	}
+
+	return PendingSlotIndex >= Slots.Num();
+}
+
+void UMyToggle::FinishIncrementalConstruction()
+{
+	UpdateGCCluster();
+	OnConstructionCompleted.Broadcast();
 }
 
 UClass* UMyToggle::GetSlotClass() const
@@ -71,17 +210,31 @@ void UMyToggle::OnSlotAdded(UPanelSlot* InSlot)
 	{
 		CastChecked<UMyToggleSlot>(InSlot)->BuildSlot(MyToggle.ToSharedRef());
 	}
+
+	// The new slot and its content are not part of the cluster, so the cluster has to be rebuilt.
+	if (IsGCClusterRoot())
+	{
+		UpdateGCCluster();
+	}
 }
 
 void UMyToggle::OnSlotRemoved(UPanelSlot* InSlot)
 {
-	if (MyToggle.IsValid())
+	// Slots shift down, rescan the ones that may still be pending.
+	PendingSlotIndex = 0;
+
+	// Objects inside a cluster can't be collected on their own, release the removed slot from it.
+	if (IsGCClusterRoot())
 	{
-		TSharedPtr<SWidget> Widget = InSlot->Content->GetCachedWidget();
-		if (Widget.IsValid())
-		{
-			MyToggle->RemoveSlot(Widget.ToSharedRef());
-		}
+		DissolveGCCluster();
+		UpdateGCCluster();
+	}
+
+	// By slot rather than by widget, pending slots only hold a placeholder and the content has no widget yet.
+	const SMyToggle::FSlot* SlateSlot = CastChecked<UMyToggleSlot>(InSlot)->GetSlateSlot();
+	if (MyToggle.IsValid() && SlateSlot != nullptr)
+	{
+		MyToggle->RemoveSlot(SlateSlot);
 	}
 }
 
@@ -92,28 +245,225 @@ TSharedPtr<SMyToggle> UMyToggle::GetToggleWidget() const
 
 bool UMyToggle::GetGeometryForSlot(UMyToggleSlot* InSlot, FGeometry& ArrangedGeometry) const
 {
-	if (InSlot->Content == nullptr)
+	TSharedPtr<SMyToggle> Canvas = GetToggleWidget();
+	const SMyToggle::FSlot* SlateSlot = InSlot->GetSlateSlot();
+	if (Canvas.IsValid() && SlateSlot != nullptr)
 	{
-		return false;
+		// Looked up in the toggle's spatial index rather than arranging every child.
+		return Canvas->FindChildGeometry(Canvas->GetCachedGeometry(), *SlateSlot, ArrangedGeometry);
 	}
 
-	TSharedPtr<SMyToggle> Canvas = GetToggleWidget();
-	if (Canvas.IsValid())
+	return false;
+}
+
+TArray<UMyToggleSlot*> UMyToggle::GetSlotsAtPosition(FVector2D AbsolutePosition) const
+{
+	TArray<UMyToggleSlot*> Result;
+	if (!MyToggle.IsValid())
+		return Result;
+
+	TArray<int32> ChildIndices;
+	MyToggle->FindChildrenAtPosition(MyToggle->GetCachedGeometry(), AbsolutePosition, ChildIndices);
+
+	// The layout asset's children are built before the slots, the slots are the last children in order.
+	const int32 FirstSlotChild = MyToggle->NumSlots() - Slots.Num();
+	for (int32 ChildIndex : ChildIndices)
 	{
-		FArrangedChildren ArrangedChildren(EVisibility::All);
-		Canvas->ArrangeChildren(Canvas->GetCachedGeometry(), ArrangedChildren);
+		const int32 SlotIndex = ChildIndex - FirstSlotChild;
+		if (!Slots.IsValidIndex(SlotIndex))
+			continue;
 
-		for (int32 ChildIndex = 0; ChildIndex < ArrangedChildren.Num(); ChildIndex++)
+		UMyToggleSlot* ToggleSlot = Cast<UMyToggleSlot>(Slots[SlotIndex]);
+		if (ToggleSlot && ToggleSlot->GetSlateSlot() == &MyToggle->GetSlot(ChildIndex))
 		{
-			if (ArrangedChildren[ChildIndex].Widget == InSlot->Content->GetCachedWidget())
-			{
-				ArrangedGeometry = ArrangedChildren[ChildIndex].Geometry;
-				return true;
-			}
+			Result.Add(ToggleSlot);
 		}
 	}
 
-	return false;
+	return Result;
+}
+
+void UMyToggle::SetCheckedState(ECheckBoxState InCheckedState)
+{
+	CheckedState = InCheckedState;
+
+	// Push directly rather than waiting for the next sync, the model may update thousands of toggles at once.
+	if (MyToggle.IsValid() && bCheckedStateSynced && !bSyncedCheckedStateBound && SyncedCheckedState != InCheckedState)
+	{
+		MyToggle->SetToggleIsChecked(InCheckedState);
+		SyncedCheckedState = InCheckedState;
+	}
+
+	UpdateMirroredState();
+}
+
+ECheckBoxState UMyToggle::GetCheckedState() const
+{
+	return CheckedState;
+}
+
+void UMyToggle::BindToBitModel(UMyToggleBitModel* Model, int32 Index)
+{
+	UnbindFromBitModel();
+
+	if (Model)
+	{
+		BoundBitModel = Model;
+		BoundBitIndex = Index;
+		Model->Bind(this, Index);
+		SetCheckedState(Model->GetState(Index));
+	}
+}
+
+void UMyToggle::UnbindFromBitModel()
+{
+	if (UMyToggleBitModel* Model = BoundBitModel.Get())
+	{
+		Model->Unbind(this, BoundBitIndex);
+	}
+
+	BoundBitModel.Reset();
+	BoundBitIndex = INDEX_NONE;
+}
+
+void UMyToggle::BindToTreeModel(UMyToggleTreeModel* Model, int32 Node)
+{
+	UnbindFromTreeModel();
+
+	if (Model)
+	{
+		BoundTreeModel = Model;
+		BoundTreeNode = Node;
+		Model->Bind(this, Node);
+		SetCheckedState(Model->GetState(Node));
+	}
+}
+
+void UMyToggle::UnbindFromTreeModel()
+{
+	if (UMyToggleTreeModel* Model = BoundTreeModel.Get())
+	{
+		Model->Unbind(this, BoundTreeNode);
+	}
+
+	BoundTreeModel.Reset();
+	BoundTreeNode = INDEX_NONE;
+}
+
+void UMyToggle::SetNavigationGroup(UMyToggleNavigationGroup* InNavigationGroup)
+{
+	NavigationGroup = InNavigationGroup;
+
+	if (MyToggle.IsValid())
+	{
+		MyToggle->SetNavigationGrid(NavigationGroup ? NavigationGroup->GetGrid() : TSharedPtr<FMyToggleNavigationGrid>());
+	}
+}
+
+void UMyToggle::ApplyCheckedState(ECheckBoxState InCheckedState)
+{
+	// A bound toggle shows what its binding returns, announcing another state would mislead listeners and models.
+	if (CheckedStateDelegate.IsBound() && !IsDesignTime())
+	{
+		// The state queue may drain many entries for the same toggle, warn once and keep the rest verbose.
+		if (!bWarnedBoundApply)
+		{
+			UE_LOG(LogMyToggle, Warning, TEXT("%s: can't apply a checked state, CheckedState is bound"), *GetPathName());
+			bWarnedBoundApply = true;
+		}
+		else
+		{
+			UE_LOG(LogMyToggle, Verbose, TEXT("%s: can't apply a checked state, CheckedState is bound"), *GetPathName());
+		}
+		return;
+	}
+
+	const ECheckBoxState Last = CheckedState;
+	if (Last != InCheckedState)
+	{
+		SetCheckedState(InCheckedState);
+		NotifyCheckedStateChanged(Last, InCheckedState);
+	}
+}
+
+FMyToggleHandle UMyToggle::GetToggleHandle()
+{
+	if (!ToggleHandle.IsValid())
+	{
+		ToggleHandle = FMyToggleRegistry::Get().Register(this);
+		FMyToggleStateQueue::Get().Initialize();
+	}
+
+	return ToggleHandle;
+}
+
+void UMyToggle::UpdateMirroredState()
+{
+	if (bMirrorState && !IsTemplate())
+	{
+		if (bStateMirrored)
+		{
+			FMyToggleStateMirror::Get().Write(ToggleHandle, CheckedState);
+		}
+		else
+		{
+			FMyToggleStateMirror::Get().Register(GetToggleHandle(), CheckedState);
+			bStateMirrored = true;
+		}
+	}
+	else if (bStateMirrored)
+	{
+		FMyToggleStateMirror::Get().Unregister(ToggleHandle);
+		bStateMirrored = false;
+	}
+}
+
+void UMyToggle::BeginDestroy()
+{
+	if (bStateMirrored)
+	{
+		FMyToggleStateMirror::Get().Unregister(ToggleHandle);
+		bStateMirrored = false;
+	}
+
+	if (ToggleHandle.IsValid())
+	{
+		FMyToggleRegistry::Get().Unregister(ToggleHandle);
+		ToggleHandle = FMyToggleHandle();
+	}
+
+	Super::BeginDestroy();
+}
+
+bool UMyToggle::CanBeClusterRoot() const
+{
+	return bCreateGCCluster;
+}
+
+void UMyToggle::UpdateGCCluster()
+{
+	// Clusters are only safe for the runtime, in the editor the designer keeps changing the slots.
+	if (!bCreateGCCluster || !GCreateGCClusters || GIsEditor || IsTemplate() || IsPendingKill())
+	{
+		return;
+	}
+
+	DissolveGCCluster();
+	CreateCluster();
+}
+
+void UMyToggle::DissolveGCCluster()
+{
+	if (IsGCClusterRoot())
+	{
+		GUObjectClusters.DissolveCluster(this);
+	}
+}
+
+bool UMyToggle::IsGCClusterRoot() const
+{
+	const FUObjectItem* RootItem = GUObjectArray.ObjectToObjectItem(this);
+	return RootItem && RootItem->HasAnyFlags(EInternalObjectFlags::ClusterRoot);
 }
 
 void UMyToggle::SlateOnToggleCheckeStateChanged(ECheckBoxState NewState)
@@ -121,7 +471,72 @@ void UMyToggle::SlateOnToggleCheckeStateChanged(ECheckBoxState NewState)
 	ECheckBoxState Last = CheckedState;
 	CheckedState = NewState;
 
-	OnToggleCheckStateChanged.Broadcast(Last, NewState);
+	// SMyToggle already shows the new state when unbound, nothing to push on the next sync.
+	SyncedCheckedState = NewState;
+	UpdateMirroredState();
+
+	NotifyCheckedStateChanged(Last, NewState);
+}
+
+void UMyToggle::SlateOnPrefetchState(ECheckBoxState State)
+{
+	// Throttled by SMyToggle::PrefetchNextState.
+	const float ResidentSeconds = MyTogglePrefetch::GetResidentSeconds();
+	const uint8 StateBit = ToggleStateToMask((uint8)State);
+	if (LayoutAsset)
+	{
+		LayoutAsset->RequestResources(StateBit, ResidentSeconds);
+	}
+
+	for (UPanelSlot* PanelSlot : Slots)
+	{
+		UMyToggleSlot* ToggleSlot = Cast<UMyToggleSlot>(PanelSlot);
+		if (ToggleSlot == nullptr || (ToggleSlotTypeToStateMask(ToggleSlot->GetSlotType(), (uint8)ToggleSlot->GetStateMask()) & StateBit) == 0)
+			continue;
+
+		// Content still waiting for incremental construction is built ahead of the scheduler.
+		if (ToggleSlot->HasPendingContent())
+		{
+			ToggleSlot->BuildPendingContent();
+		}
+
+		MyTogglePrefetch::RequestWidgetResources(ToggleSlot->Content, ResidentSeconds);
+	}
+}
+
+bool UMyToggle::RestoreCheckedState(ECheckBoxState InCheckedState)
+{
+	if (CheckedStateDelegate.IsBound() && !IsDesignTime())
+	{
+		return false;
+	}
+
+	if (CheckedState != InCheckedState)
+	{
+		SetCheckedState(InCheckedState);
+		WriteCheckedStateToModels(InCheckedState);
+	}
+	return true;
+}
+
+void UMyToggle::WriteCheckedStateToModels(ECheckBoxState NewState)
+{
+	if (UMyToggleBitModel* Model = BoundBitModel.Get())
+	{
+		Model->SetState(BoundBitIndex, NewState);
+	}
+
+	if (UMyToggleTreeModel* Model = BoundTreeModel.Get())
+	{
+		Model->SetState(BoundTreeNode, NewState);
+	}
+}
+
+void UMyToggle::NotifyCheckedStateChanged(ECheckBoxState LastState, ECheckBoxState NewState)
+{
+	WriteCheckedStateToModels(NewState);
+
+	OnToggleCheckStateChanged.Broadcast(LastState, NewState);
 }
 
 #undef LOCTEXT_NAMESPACE
\ No newline at end of file
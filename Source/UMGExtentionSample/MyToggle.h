@@ -7,13 +7,19 @@
 #include "Components/PanelWidget.h"
 #include "SlateCore/Public/Styling/SlateTypes.h"
 #include "SMyToggle.h"
+#include "MyToggleRegistry.h"
 #include "MyToggle.generated.h"
 
 class SMyToggle;
 class UMyToggleSlot;
+class UMyToggleLayoutAsset;
+class UMyToggleBitModel;
+class UMyToggleTreeModel;
+class UMyToggleNavigationGroup;
 class SWidget;
 
 DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FOnToggleStateChanged, ECheckBoxState, LastState, ECheckBoxState, NewState);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnToggleConstructionCompleted);
 /**
  * 
  */
@@ -31,10 +37,129 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interaction")
 	bool IsFocusable;
 
+	/**
+	 * With a bound CheckedState, shows the clicked state immediately instead of waiting for the binding.
+	 * The binding's next change replaces it, or it is rolled back after OptimisticTimeout.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interaction")
+	bool bOptimisticUpdate;
+
+	/** Seconds the binding has to follow a click before the optimistic state is rolled back */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Interaction", meta = (EditCondition = "bOptimisticUpdate", ClampMin = "0.0", UIMin = "0.0"))
+	float OptimisticTimeout;
+
+	/** Children built from plain data before the regular slots, without any per-slot UObject */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Appearance")
+	UMyToggleLayoutAsset* LayoutAsset;
+
 	UPROPERTY(BlueprintAssignable, Category = "Toggle|Event")
 	FOnToggleStateChanged OnToggleCheckStateChanged;
 
+	/**
+	 * Lets the toggle form a GC cluster with its slots and their content, so they are traced as one object.
+	 * Only enable it for toggles whose content doesn't swap object references (brushes, fonts) at runtime,
+	 * references added after the cluster was created are not seen by the garbage collector.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "Performance")
+	bool bCreateGCCluster;
+
+	/**
+	 * Builds the slot content over several frames under the UMGExt.Toggle.IncrementalBuildBudgetMs budget.
+	 * Slots show placeholders that keep their layout until their content is built.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "Performance")
+	bool bIncrementalConstruction;
+
+	/** Among toggles equally visible, higher priorities are built first in incremental construction */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, AdvancedDisplay, Category = "Performance", meta = (EditCondition = "bIncrementalConstruction"))
+	int32 ConstructionPriority;
+
+	/**
+	 * On hover and keyboard focus, gets the state a click would show ready: builds its pending slot content
+	 * and asks the texture streamer to load the textures of its brushes, so switching doesn't hitch.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "Performance")
+	bool bPrefetchNextState;
+
+	/**
+	 * Publishes the checked state to FMyToggleStateMirror, where any thread can read it by toggle handle.
+	 * A bound CheckedState is mirrored as last pushed or set on this toggle, not re-evaluated.
+	 */
+	UPROPERTY(EditAnywhere, AdvancedDisplay, Category = "Performance")
+	bool bMirrorState;
+
+	/** Called once every slot has its real content, immediately after rebuild unless in incremental construction */
+	UPROPERTY(BlueprintAssignable, Category = "Toggle|Event")
+	FOnToggleConstructionCompleted OnConstructionCompleted;
+
 public:
+	// Begin UObject
+	virtual void BeginDestroy() override;
+	virtual bool CanBeClusterRoot() const override;
+	// End UObject
+
+	/** (Re)creates the GC cluster if clustering is enabled for this toggle. */
+	void UpdateGCCluster();
+
+	/** Dissolves the GC cluster rooted at this toggle, if there is one. */
+	void DissolveGCCluster();
+
+	/** Whether this toggle currently is the root of a GC cluster. */
+	bool IsGCClusterRoot() const;
+
+	/** Whether slots are still waiting for their content in incremental construction. */
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	bool IsConstructionPending() const;
+
+	/** Builds pending slot content until EndTime (FPlatformTime::Seconds), returns true once all of it is built. */
+	bool BuildPendingSlots(double EndTime);
+
+	/** Called by the build scheduler once BuildPendingSlots completed. */
+	void FinishIncrementalConstruction();
+
+	/** Rebuilds the Slate children from the layout asset and the slots, e.g. after the layout asset was edited. */
+	void RebuildLayoutSlots();
+
+	/** Sets the checked state without broadcasting OnToggleCheckStateChanged, a bound CheckedState keeps its binding */
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	void SetCheckedState(ECheckBoxState InCheckedState);
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	ECheckBoxState GetCheckedState() const;
+
+	/**
+	 * Sets the checked state like a click would, broadcasting OnToggleCheckStateChanged if it changed.
+	 * Does nothing on a toggle whose CheckedState is bound, the binding decides what it shows.
+	 */
+	void ApplyCheckedState(ECheckBoxState InCheckedState);
+
+	/**
+	 * Sets a saved checked state: the bound models follow, OnToggleCheckStateChanged isn't broadcast.
+	 * Returns false without changing anything if CheckedState is bound.
+	 */
+	bool RestoreCheckedState(ECheckBoxState InCheckedState);
+
+	/** Handle to change this toggle from other threads through FMyToggleStateQueue, made on first use on the game thread. */
+	FMyToggleHandle GetToggleHandle();
+
+	/** Mirrors a flag of the model: the toggle follows the flag and clicks are written back to it */
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	void BindToBitModel(UMyToggleBitModel* Model, int32 Index);
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	void UnbindFromBitModel();
+
+	/** Mirrors a node of the tree: the toggle shows the node's aggregated state and clicks set the node's subtree */
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	void BindToTreeModel(UMyToggleTreeModel* Model, int32 Node);
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	void UnbindFromTreeModel();
+
+	/** Navigates between this toggle and the others of the group through the group's grid, null leaves the group */
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	void SetNavigationGroup(UMyToggleNavigationGroup* InNavigationGroup);
+
     // Begin UVisual Interface
     virtual void ReleaseSlateResources(bool bReleaseChildren) override;
     // End UVisual Interface
@@ -48,6 +173,10 @@ public:
     
 	TSharedPtr<SMyToggle> GetToggleWidget()const;
 	bool GetGeometryForSlot(UMyToggleSlot* InSlot, FGeometry& ArrangedGeometry) const;
+
+	/** Slots whose content is drawn at a screen position, top-most first. Uses the geometry of the last paint. */
+	UFUNCTION(BlueprintCallable, Category = "Toggle")
+	TArray<UMyToggleSlot*> GetSlotsAtPosition(FVector2D AbsolutePosition) const;
 protected:
     // Begin UWidget
     virtual TSharedRef<SWidget> RebuildWidget() override;
@@ -60,10 +189,50 @@ protected:
     virtual void OnSlotRemoved(UPanelSlot* InSlot) override;
     // End UPanelWidget
 
+	/** Adds the layout asset's children and the slots' to MyToggle. */
+	void BuildToggleSlots(bool bDeferContent);
+
 	void SlateOnToggleCheckeStateChanged(ECheckBoxState NewState);
+
+	/** Builds and requests the resources of the slots shown in State, see bPrefetchNextState. */
+	void SlateOnPrefetchState(ECheckBoxState State);
+
+	/** Registers, updates or removes this toggle's entry in the state mirror following bMirrorState. */
+	void UpdateMirroredState();
+
+	/** Writes a new state back to the bound bit and tree models. */
+	void WriteCheckedStateToModels(ECheckBoxState NewState);
+
+	/** Writes a new state back to the bound models and broadcasts it. */
+	void NotifyCheckedStateChanged(ECheckBoxState LastState, ECheckBoxState NewState);
 	
 protected:
 	TSharedPtr<SMyToggle> MyToggle;
 
+	/** First slot that may still have pending content. */
+	int32 PendingSlotIndex;
+
+	/** What SynchronizeProperties last pushed to MyToggle, to skip rebuilding an unchanged attribute. */
+	bool bCheckedStateSynced;
+	bool bSyncedCheckedStateBound;
+	ECheckBoxState SyncedCheckedState;
+	TWeakObjectPtr<UObject> SyncedCheckedStateObject;
+	FName SyncedCheckedStateFunction;
+
+	/** ApplyCheckedState already warned that CheckedState is bound. */
+	bool bWarnedBoundApply;
+
+	TWeakObjectPtr<UMyToggleBitModel> BoundBitModel;
+	int32 BoundBitIndex;
+
+	TWeakObjectPtr<UMyToggleTreeModel> BoundTreeModel;
+	int32 BoundTreeNode;
+
+	FMyToggleHandle ToggleHandle;
+	bool bStateMirrored;
+
+	UPROPERTY(Transient)
+	UMyToggleNavigationGroup* NavigationGroup;
+
 	PROPERTY_BINDING_IMPLEMENTATION(ECheckBoxState, CheckedState)
 };
@@ -0,0 +1,208 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Layout/ArrangedChildren.h"
+#include "Rendering/SlateLayoutTransform.h"
+#include "Widgets/SNullWidget.h"
+#include "UObject/GCObject.h"
+#include "UObject/UObjectGlobals.h"
+#include "UObject/Package.h"
+#include "UObject/GarbageCollection.h"
+#include "Components/TextBlock.h"
+#include "SMyToggle.h"
+#include "MyToggle.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMyToggleBenchmark, Log, All);
+
+namespace MyToggleBenchmark
+{
+	static float SumSlotOffsets(const SMyToggle::FSlot& Slot)
+	{
+		const FMargin Offset = Slot.OffsetAttr.Get();
+		return Offset.Left + Offset.Top + Slot.ZOrderAttr.Get();
+	}
+
+	struct FSlotStorageTimes
+	{
+		double Construct;
+		double Iterate;
+		double Arrange;
+	};
+
+	/** Times iterating the slots of a built toggle and arranging it. */
+	static void TimeToggle(SMyToggle& Toggle, int32 NumPasses, FSlotStorageTimes& OutTimes, float& InOutChecksum)
+	{
+		FChildren* Children = Toggle.GetChildren();
+		double StartTime = FPlatformTime::Seconds();
+		for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+		{
+			for (int32 Index = 0; Index < Children->Num(); ++Index)
+			{
+				InOutChecksum += SumSlotOffsets(static_cast<const SMyToggle::FSlot&>(Children->GetSlotAt(Index)));
+			}
+		}
+		OutTimes.Iterate = FPlatformTime::Seconds() - StartTime;
+
+		const FGeometry Geometry = FGeometry::MakeRoot(FVector2D(1920, 1080), FSlateLayoutTransform());
+		StartTime = FPlatformTime::Seconds();
+		for (int32 Pass = 0; Pass < NumPasses; ++Pass)
+		{
+			FArrangedChildren ArrangedChildren(EVisibility::All);
+			Toggle.ArrangeChildren(Geometry, ArrangedChildren);
+		}
+		OutTimes.Arrange = FPlatformTime::Seconds() - StartTime;
+	}
+
+	/** Declarative slots are allocated one by one before the toggle exists, like TPanelChildren. */
+	static TSharedRef<SMyToggle> MakeHeapToggle(int32 NumChildren)
+	{
+		SMyToggle::FArguments HeapArgs;
+		for (int32 Index = 0; Index < NumChildren; ++Index)
+		{
+			HeapArgs
+			+ SMyToggle::Slot()
+				.Offset(FMargin(Index, Index, 10, 10))
+				[
+					SNullWidget::NullWidget
+				];
+		}
+		return SArgumentNew(HeapArgs, SMyToggle);
+	}
+
+	/** Slots added to a live toggle come from blocks owned by that toggle, reserved up front as UMyToggle does. */
+	static TSharedRef<SMyToggle> MakePooledToggle(int32 NumChildren)
+	{
+		TSharedRef<SMyToggle> Toggle = SNew(SMyToggle);
+		Toggle->ReserveSlots(NumChildren);
+		for (int32 Index = 0; Index < NumChildren; ++Index)
+		{
+			Toggle->AddSlot()
+				.Offset(FMargin(Index, Index, 10, 10))
+				[
+					SNullWidget::NullWidget
+				];
+		}
+		return Toggle;
+	}
+
+	/**
+	 * Compares the same SMyToggle with its slots in its pool against one heap allocation per slot,
+	 * then reports the slot storage of a typical two-slot toggle on both.
+	 * Usage: UMGExt.Toggle.BenchSlots [NumChildren=500] [NumPasses=1000]
+	 */
+	static void BenchSlotStorage(const TArray<FString>& Args)
+	{
+		const int32 NumChildren = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 500;
+		const int32 NumPasses = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 1000;
+		const int32 NumSmallChildren = 2;
+		float Checksum = 0.0f;
+
+		FSlotStorageTimes HeapTimes;
+		double StartTime = FPlatformTime::Seconds();
+		TSharedRef<SMyToggle> HeapToggle = MakeHeapToggle(NumChildren);
+		HeapTimes.Construct = FPlatformTime::Seconds() - StartTime;
+		TimeToggle(*HeapToggle, NumPasses, HeapTimes, Checksum);
+
+		FSlotStorageTimes PooledTimes;
+		StartTime = FPlatformTime::Seconds();
+		TSharedRef<SMyToggle> PooledToggle = MakePooledToggle(NumChildren);
+		PooledTimes.Construct = FPlatformTime::Seconds() - StartTime;
+		TimeToggle(*PooledToggle, NumPasses, PooledTimes, Checksum);
+
+		TSharedRef<SMyToggle> SmallHeapToggle = MakeHeapToggle(NumSmallChildren);
+		TSharedRef<SMyToggle> SmallPooledToggle = MakePooledToggle(NumSmallChildren);
+
+		UE_LOG(LogMyToggleBenchmark, Display, TEXT("Slot storage, %d children, %d passes (checksum %f)"), NumChildren, NumPasses, Checksum);
+		UE_LOG(LogMyToggleBenchmark, Display, TEXT("  Heap   construct %8.3f ms  iterate %8.3f ms  arrange %8.3f ms  %8llu bytes"),
+			HeapTimes.Construct * 1000.0, HeapTimes.Iterate * 1000.0, HeapTimes.Arrange * 1000.0, (uint64)HeapToggle->GetSlotStorageSize());
+		UE_LOG(LogMyToggleBenchmark, Display, TEXT("  Pooled construct %8.3f ms  iterate %8.3f ms  arrange %8.3f ms  %8llu bytes"),
+			PooledTimes.Construct * 1000.0, PooledTimes.Iterate * 1000.0, PooledTimes.Arrange * 1000.0, (uint64)PooledToggle->GetSlotStorageSize());
+		UE_LOG(LogMyToggleBenchmark, Display, TEXT("Slot storage per toggle, %d children: heap %llu bytes, pooled %llu bytes"),
+			NumSmallChildren, (uint64)SmallHeapToggle->GetSlotStorageSize(), (uint64)SmallPooledToggle->GetSlotStorageSize());
+	}
+
+	static FAutoConsoleCommand BenchSlotStorageCommand(
+		TEXT("UMGExt.Toggle.BenchSlots"),
+		TEXT("Benchmarks pooled SMyToggle slot storage against per-slot heap allocation. Args: [NumChildren=500] [NumPasses=1000]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchSlotStorage));
+
+	/** Keeps the benchmark toggles alive, like a screen holding on to its widgets. */
+	struct FBenchToggleReferencer : public FGCObject
+	{
+		TArray<UMyToggle*> Toggles;
+
+		virtual void AddReferencedObjects(FReferenceCollector& Collector) override
+		{
+			Collector.AddReferencedObjects(Toggles);
+		}
+	};
+
+	static double TimeCollectGarbage(int32 NumRuns)
+	{
+		const double StartTime = FPlatformTime::Seconds();
+		for (int32 Run = 0; Run < NumRuns; ++Run)
+		{
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		}
+		return (FPlatformTime::Seconds() - StartTime) / NumRuns;
+	}
+
+	/**
+	 * Measures full GC time with live toggles, first traced one object at a time then clustered.
+	 * Run it in a cooked or -game session, clusters are never created in the editor.
+	 * Usage: UMGExt.Toggle.BenchGCClusters [NumToggles=1000] [SlotsPerToggle=4]
+	 */
+	static void BenchGCClusters(const TArray<FString>& Args)
+	{
+		const int32 NumToggles = Args.Num() > 0 ? FMath::Max(1, FCString::Atoi(*Args[0])) : 1000;
+		const int32 SlotsPerToggle = Args.Num() > 1 ? FMath::Max(1, FCString::Atoi(*Args[1])) : 4;
+		const int32 NumRuns = 5;
+
+		FBenchToggleReferencer Referencer;
+		for (int32 ToggleIndex = 0; ToggleIndex < NumToggles; ++ToggleIndex)
+		{
+			UMyToggle* Toggle = NewObject<UMyToggle>(GetTransientPackage());
+			Toggle->bCreateGCCluster = true;
+			for (int32 SlotIndex = 0; SlotIndex < SlotsPerToggle; ++SlotIndex)
+			{
+				Toggle->AddChild(NewObject<UTextBlock>(Toggle));
+			}
+			Referencer.Toggles.Add(Toggle);
+		}
+
+		// Settle anything left over from before so both runs start from the same heap.
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+		const double UnclusteredTime = TimeCollectGarbage(NumRuns);
+
+		int32 NumClusters = 0;
+		for (UMyToggle* Toggle : Referencer.Toggles)
+		{
+			Toggle->UpdateGCCluster();
+			NumClusters += Toggle->IsGCClusterRoot() ? 1 : 0;
+		}
+		const double ClusteredTime = TimeCollectGarbage(NumRuns);
+
+		for (UMyToggle* Toggle : Referencer.Toggles)
+		{
+			Toggle->DissolveGCCluster();
+		}
+
+		UE_LOG(LogMyToggleBenchmark, Display, TEXT("GC with %d toggles of %d slots, average of %d runs"), NumToggles, SlotsPerToggle, NumRuns);
+		UE_LOG(LogMyToggleBenchmark, Display, TEXT("  Unclustered %8.3f ms"), UnclusteredTime * 1000.0);
+		UE_LOG(LogMyToggleBenchmark, Display, TEXT("  Clustered   %8.3f ms (%d clusters)"), ClusteredTime * 1000.0, NumClusters);
+		if (NumClusters == 0)
+		{
+			UE_LOG(LogMyToggleBenchmark, Warning, TEXT("  No cluster was created, gc.CreateGCClusters is off or this is an editor session."));
+		}
+
+		Referencer.Toggles.Empty();
+		CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS, true);
+	}
+
+	static FAutoConsoleCommand BenchGCClustersCommand(
+		TEXT("UMGExt.Toggle.BenchGCClusters"),
+		TEXT("Measures GC time with live toggles with and without GC clusters. Args: [NumToggles=1000] [SlotsPerToggle=4]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchGCClusters));
+}
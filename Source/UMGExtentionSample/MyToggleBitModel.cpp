@@ -0,0 +1,220 @@
+#include "MyToggleBitModel.h"
+#include "MyToggle.h"
+
+/////////////////////////////////////////////////////
+// UMyToggleBitModel
+
+UMyToggleBitModel::UMyToggleBitModel(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, NumFlags(0)
+{
+}
+
+uint32 UMyToggleBitModel::GetWordMask(int32 WordIndex) const
+{
+	const int32 NumBitsInWord = NumFlags - WordIndex * 32;
+	return NumBitsInWord >= 32 ? ~0u : ((1u << NumBitsInWord) - 1);
+}
+
+template<typename OpType>
+void UMyToggleBitModel::ModifyWords(OpType Op)
+{
+	TArray<int32> ChangedIndices;
+
+	for (int32 WordIndex = 0; WordIndex < CheckedWords.Num(); ++WordIndex)
+	{
+		const uint32 OldChecked = CheckedWords[WordIndex];
+		const uint32 OldUndetermined = UndeterminedWords[WordIndex];
+
+		uint32 NewChecked = OldChecked;
+		uint32 NewUndetermined = OldUndetermined;
+		Op(WordIndex, NewChecked, NewUndetermined);
+
+		// A flag is either checked or undetermined, never both.
+		const uint32 WordMask = GetWordMask(WordIndex);
+		NewUndetermined &= WordMask;
+		NewChecked &= WordMask & ~NewUndetermined;
+
+		CheckedWords[WordIndex] = NewChecked;
+		UndeterminedWords[WordIndex] = NewUndetermined;
+
+		uint32 Changed = (OldChecked ^ NewChecked) | (OldUndetermined ^ NewUndetermined);
+		while (Changed)
+		{
+			const uint32 Bit = FMath::CountTrailingZeros(Changed);
+			ChangedIndices.Add(WordIndex * 32 + Bit);
+			Changed &= Changed - 1;
+		}
+	}
+
+	if (ChangedIndices.Num() > 0)
+	{
+		NotifyChanged(ChangedIndices);
+	}
+}
+
+void UMyToggleBitModel::NotifyChanged(const TArray<int32>& ChangedIndices)
+{
+	if (Bindings.Num() > 0)
+	{
+		TArray<TWeakObjectPtr<UMyToggle>, TInlineAllocator<4>> BoundToggles;
+		for (int32 Index : ChangedIndices)
+		{
+			BoundToggles.Reset();
+			Bindings.MultiFind(Index, BoundToggles);
+
+			const ECheckBoxState State = GetState(Index);
+			for (const TWeakObjectPtr<UMyToggle>& Toggle : BoundToggles)
+			{
+				if (Toggle.IsValid())
+				{
+					Toggle->SetCheckedState(State);
+				}
+			}
+		}
+	}
+
+	OnFlagsChanged.Broadcast(ChangedIndices);
+}
+
+void UMyToggleBitModel::SetNum(int32 InNumFlags)
+{
+	InNumFlags = FMath::Max(InNumFlags, 0);
+	const int32 OldNumFlags = NumFlags;
+
+	NumFlags = InNumFlags;
+	CheckedWords.SetNumZeroed(NumWordsFor(NumFlags));
+	UndeterminedWords.SetNumZeroed(NumWordsFor(NumFlags));
+
+	// Clear the bits past the end when shrinking, so growing again starts unchecked.
+	if (NumFlags < OldNumFlags && CheckedWords.Num() > 0)
+	{
+		const int32 LastWord = CheckedWords.Num() - 1;
+		CheckedWords[LastWord] &= GetWordMask(LastWord);
+		UndeterminedWords[LastWord] &= GetWordMask(LastWord);
+	}
+}
+
+ECheckBoxState UMyToggleBitModel::GetState(int32 Index) const
+{
+	if (Index < 0 || Index >= NumFlags)
+	{
+		return ECheckBoxState::Unchecked;
+	}
+
+	const uint32 Bit = 1u << (Index & 31);
+	if (UndeterminedWords[Index >> 5] & Bit)
+	{
+		return ECheckBoxState::Undetermined;
+	}
+
+	return (CheckedWords[Index >> 5] & Bit) ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+void UMyToggleBitModel::SetState(int32 Index, ECheckBoxState State)
+{
+	if (Index < 0 || Index >= NumFlags || GetState(Index) == State)
+	{
+		return;
+	}
+
+	const int32 WordIndex = Index >> 5;
+	const uint32 Bit = 1u << (Index & 31);
+	CheckedWords[WordIndex] = State == ECheckBoxState::Checked ? (CheckedWords[WordIndex] | Bit) : (CheckedWords[WordIndex] & ~Bit);
+	UndeterminedWords[WordIndex] = State == ECheckBoxState::Undetermined ? (UndeterminedWords[WordIndex] | Bit) : (UndeterminedWords[WordIndex] & ~Bit);
+
+	TArray<int32> ChangedIndices;
+	ChangedIndices.Add(Index);
+	NotifyChanged(ChangedIndices);
+}
+
+void UMyToggleBitModel::SetAll(ECheckBoxState State)
+{
+	const uint32 CheckedFill = State == ECheckBoxState::Checked ? ~0u : 0u;
+	const uint32 UndeterminedFill = State == ECheckBoxState::Undetermined ? ~0u : 0u;
+
+	ModifyWords([CheckedFill, UndeterminedFill](int32 WordIndex, uint32& Checked, uint32& Undetermined)
+	{
+		Checked = CheckedFill;
+		Undetermined = UndeterminedFill;
+	});
+}
+
+void UMyToggleBitModel::InvertAll()
+{
+	ModifyWords([](int32 WordIndex, uint32& Checked, uint32& Undetermined)
+	{
+		Checked = ~Checked & ~Undetermined;
+	});
+}
+
+void UMyToggleBitModel::ApplyMask(const UMyToggleBitModel* Mask, ECheckBoxState State)
+{
+	if (Mask == nullptr)
+	{
+		return;
+	}
+
+	const TArray<uint32>& MaskWords = Mask->CheckedWords;
+	const uint32 CheckedFill = State == ECheckBoxState::Checked ? ~0u : 0u;
+	const uint32 UndeterminedFill = State == ECheckBoxState::Undetermined ? ~0u : 0u;
+
+	ModifyWords([&MaskWords, CheckedFill, UndeterminedFill](int32 WordIndex, uint32& Checked, uint32& Undetermined)
+	{
+		const uint32 MaskWord = MaskWords.IsValidIndex(WordIndex) ? MaskWords[WordIndex] : 0u;
+		Checked = (Checked & ~MaskWord) | (CheckedFill & MaskWord);
+		Undetermined = (Undetermined & ~MaskWord) | (UndeterminedFill & MaskWord);
+	});
+}
+
+FMyToggleBitSnapshot UMyToggleBitModel::TakeSnapshot() const
+{
+	FMyToggleBitSnapshot Snapshot;
+	Snapshot.CheckedWords = CheckedWords;
+	Snapshot.UndeterminedWords = UndeterminedWords;
+	Snapshot.NumFlags = NumFlags;
+	return Snapshot;
+}
+
+TArray<int32> UMyToggleBitModel::DiffAgainstSnapshot(const FMyToggleBitSnapshot& Snapshot) const
+{
+	TArray<int32> ChangedIndices;
+
+	for (int32 WordIndex = 0; WordIndex < CheckedWords.Num(); ++WordIndex)
+	{
+		const uint32 SnapshotChecked = Snapshot.CheckedWords.IsValidIndex(WordIndex) ? Snapshot.CheckedWords[WordIndex] : 0u;
+		const uint32 SnapshotUndetermined = Snapshot.UndeterminedWords.IsValidIndex(WordIndex) ? Snapshot.UndeterminedWords[WordIndex] : 0u;
+
+		uint32 Changed = (CheckedWords[WordIndex] ^ SnapshotChecked) | (UndeterminedWords[WordIndex] ^ SnapshotUndetermined);
+		Changed &= GetWordMask(WordIndex);
+		while (Changed)
+		{
+			ChangedIndices.Add(WordIndex * 32 + FMath::CountTrailingZeros(Changed));
+			Changed &= Changed - 1;
+		}
+	}
+
+	return ChangedIndices;
+}
+
+void UMyToggleBitModel::RestoreSnapshot(const FMyToggleBitSnapshot& Snapshot)
+{
+	ModifyWords([&Snapshot](int32 WordIndex, uint32& Checked, uint32& Undetermined)
+	{
+		Checked = Snapshot.CheckedWords.IsValidIndex(WordIndex) ? Snapshot.CheckedWords[WordIndex] : 0u;
+		Undetermined = Snapshot.UndeterminedWords.IsValidIndex(WordIndex) ? Snapshot.UndeterminedWords[WordIndex] : 0u;
+	});
+}
+
+void UMyToggleBitModel::Bind(UMyToggle* Toggle, int32 Index)
+{
+	if (Toggle)
+	{
+		Bindings.AddUnique(Index, Toggle);
+	}
+}
+
+void UMyToggleBitModel::Unbind(UMyToggle* Toggle, int32 Index)
+{
+	Bindings.RemoveSingle(Index, Toggle);
+}
@@ -0,0 +1,115 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/Object.h"
+#include "Styling/SlateTypes.h"
+#include "MyToggleBitModel.generated.h"
+
+class UMyToggle;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnToggleFlagsChanged, const TArray<int32>&, ChangedIndices);
+
+/** Copy of a bit model's states, used to detect what changed since. */
+USTRUCT(BlueprintType)
+struct UMGEXTENTIONSAMPLE_API FMyToggleBitSnapshot
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY()
+	TArray<uint32> CheckedWords;
+
+	UPROPERTY()
+	TArray<uint32> UndeterminedWords;
+
+	UPROPERTY()
+	int32 NumFlags;
+
+	FMyToggleBitSnapshot()
+		: NumFlags(0)
+	{
+	}
+};
+
+/**
+ * Large set of toggle states packed two bit planes wide: one for checked, one for undetermined.
+ * Bulk operations run a 32-bit word at a time, and only the toggles bound to flags whose
+ * state actually changed are updated.
+ */
+UCLASS(BlueprintType)
+class UMGEXTENTIONSAMPLE_API UMyToggleBitModel : public UObject
+{
+	GENERATED_UCLASS_BODY()
+public:
+	/** Called once per operation with every flag whose state changed */
+	UPROPERTY(BlueprintAssignable, Category = "Toggle Model|Event")
+	FOnToggleFlagsChanged OnFlagsChanged;
+
+public:
+	/** Resizes the model, new flags are unchecked */
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	void SetNum(int32 InNumFlags);
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	int32 Num() const
+	{
+		return NumFlags;
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	ECheckBoxState GetState(int32 Index) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	void SetState(int32 Index, ECheckBoxState State);
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	void SetAll(ECheckBoxState State);
+
+	/** Flips checked and unchecked flags, undetermined ones stay undetermined */
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	void InvertAll();
+
+	/** Sets every flag that is set in Mask to State, Mask is read as checked / not checked */
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	void ApplyMask(const UMyToggleBitModel* Mask, ECheckBoxState State);
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	FMyToggleBitSnapshot TakeSnapshot() const;
+
+	/** Indices of the flags whose state differs from the snapshot */
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	TArray<int32> DiffAgainstSnapshot(const FMyToggleBitSnapshot& Snapshot) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	void RestoreSnapshot(const FMyToggleBitSnapshot& Snapshot);
+
+	/** Keeps the toggle's checked state in sync with a flag, use UMyToggle::BindToBitModel */
+	void Bind(UMyToggle* Toggle, int32 Index);
+	void Unbind(UMyToggle* Toggle, int32 Index);
+
+private:
+	static int32 NumWordsFor(int32 InNumFlags)
+	{
+		return (InNumFlags + 31) / 32;
+	}
+
+	/** Bits of the last word that hold flags, the rest is kept zero. */
+	uint32 GetWordMask(int32 WordIndex) const;
+
+	/**
+	 * Runs Op(WordIndex, CheckedWord, UndeterminedWord) on every word, then notifies the toggles of the
+	 * flags that changed and broadcasts OnFlagsChanged once.
+	 */
+	template<typename OpType>
+	void ModifyWords(OpType Op);
+
+	void NotifyChanged(const TArray<int32>& ChangedIndices);
+
+	TArray<uint32> CheckedWords;
+	TArray<uint32> UndeterminedWords;
+	int32 NumFlags;
+
+	TMultiMap<int32, TWeakObjectPtr<UMyToggle>> Bindings;
+};
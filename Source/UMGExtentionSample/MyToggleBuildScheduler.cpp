@@ -0,0 +1,111 @@
+#include "MyToggleBuildScheduler.h"
+#include "MyToggle.h"
+#include "SMyToggle.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+
+static float GMyToggleIncrementalBuildBudgetMs = 2.0f;
+static FAutoConsoleVariableRef CVarMyToggleIncrementalBuildBudgetMs(
+	TEXT("UMGExt.Toggle.IncrementalBuildBudgetMs"),
+	GMyToggleIncrementalBuildBudgetMs,
+	TEXT("Time in milliseconds spent per frame building the content of toggles in incremental construction mode."));
+
+FMyToggleBuildScheduler& FMyToggleBuildScheduler::Get()
+{
+	static FMyToggleBuildScheduler Scheduler;
+	return Scheduler;
+}
+
+FMyToggleBuildScheduler::FMyToggleBuildScheduler()
+	: NextSequence(0)
+{
+}
+
+void FMyToggleBuildScheduler::Enqueue(UMyToggle* Toggle)
+{
+	Cancel(Toggle);
+
+	FPendingToggle Entry;
+	Entry.Toggle = Toggle;
+	Entry.Sequence = NextSequence++;
+	Pending.Add(Entry);
+}
+
+void FMyToggleBuildScheduler::Cancel(UMyToggle* Toggle)
+{
+	Pending.RemoveAll([Toggle](const FPendingToggle& Entry) { return Entry.Toggle.Get() == Toggle; });
+}
+
+void FMyToggleBuildScheduler::Tick(float DeltaTime)
+{
+	Pending.RemoveAll([](const FPendingToggle& Entry) { return !Entry.Toggle.IsValid(); });
+
+	// Toggles on screen first, their placeholders are what the player is looking at.
+	Pending.Sort([](const FPendingToggle& A, const FPendingToggle& B)
+	{
+		const UMyToggle* ToggleA = A.Toggle.Get();
+		const UMyToggle* ToggleB = B.Toggle.Get();
+
+		TSharedPtr<SMyToggle> WidgetA = ToggleA->GetToggleWidget();
+		TSharedPtr<SMyToggle> WidgetB = ToggleB->GetToggleWidget();
+		const bool bVisibleA = WidgetA.IsValid() && WidgetA->WasPaintedRecently();
+		const bool bVisibleB = WidgetB.IsValid() && WidgetB->WasPaintedRecently();
+		if (bVisibleA != bVisibleB)
+		{
+			return bVisibleA;
+		}
+
+		if (ToggleA->ConstructionPriority != ToggleB->ConstructionPriority)
+		{
+			return ToggleA->ConstructionPriority > ToggleB->ConstructionPriority;
+		}
+
+		return A.Sequence < B.Sequence;
+	});
+
+	const double EndTime = FPlatformTime::Seconds() + GMyToggleIncrementalBuildBudgetMs / 1000.0;
+
+	TArray<TWeakObjectPtr<UMyToggle>, TInlineAllocator<8>> Completed;
+	int32 NumProcessed = 0;
+	while (NumProcessed < Pending.Num())
+	{
+		UMyToggle* Toggle = Pending[NumProcessed].Toggle.Get();
+		if (Toggle && !Toggle->BuildPendingSlots(EndTime))
+		{
+			break;
+		}
+
+		Completed.Add(Toggle);
+		++NumProcessed;
+		if (FPlatformTime::Seconds() >= EndTime)
+		{
+			break;
+		}
+	}
+
+	Pending.RemoveAt(0, FMath::Min(NumProcessed, Pending.Num()));
+
+	// Completion events run game code that may queue or cancel toggles, so only fire them once the queue is settled.
+	for (const TWeakObjectPtr<UMyToggle>& Toggle : Completed)
+	{
+		if (Toggle.IsValid())
+		{
+			Toggle->FinishIncrementalConstruction();
+		}
+	}
+}
+
+bool FMyToggleBuildScheduler::IsTickable() const
+{
+	return Pending.Num() > 0;
+}
+
+bool FMyToggleBuildScheduler::IsTickableWhenPaused() const
+{
+	return true;
+}
+
+TStatId FMyToggleBuildScheduler::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FMyToggleBuildScheduler, STATGROUP_Tickables);
+}
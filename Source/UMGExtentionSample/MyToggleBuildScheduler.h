@@ -0,0 +1,50 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UMyToggle;
+
+/**
+ * Builds the slot content of toggles in incremental construction mode across frames, under a per-frame
+ * time budget (UMGExt.Toggle.IncrementalBuildBudgetMs). Toggles painted last frame are served first,
+ * then by their ConstructionPriority, then in the order they were queued.
+ */
+class UMGEXTENTIONSAMPLE_API FMyToggleBuildScheduler : public FTickableGameObject
+{
+public:
+	static FMyToggleBuildScheduler& Get();
+
+	/** Queues a toggle whose slots still have placeholder content. */
+	void Enqueue(UMyToggle* Toggle);
+
+	/** Drops a toggle from the queue, e.g. when its Slate widget is released. */
+	void Cancel(UMyToggle* Toggle);
+
+	int32 GetNumPending() const
+	{
+		return Pending.Num();
+	}
+
+	// Begin FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableWhenPaused() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject
+
+private:
+	struct FPendingToggle
+	{
+		TWeakObjectPtr<UMyToggle> Toggle;
+		uint64 Sequence;
+	};
+
+	FMyToggleBuildScheduler();
+
+	TArray<FPendingToggle> Pending;
+	uint64 NextSequence;
+};
@@ -0,0 +1,101 @@
+#include "MyToggleFrameStats.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+CSV_DEFINE_CATEGORY(UMGExtToggle, true);
+
+namespace MyToggleFrameStats
+{
+	static FMyToggleFrameStats CurrentFrame;
+	static FMyToggleFrameStats PreviousFrame;
+	static FDelegateHandle EndFrameHandle;
+	static bool bTimingForced = false;
+
+	static void OnEndFrame()
+	{
+		const FMyToggleFrameStats& Stats = CurrentFrame;
+
+		CSV_CUSTOM_STAT(UMGExtToggle, ActiveToggles, Stats.NumActiveToggles, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, ChildrenArranged, Stats.NumChildrenArranged, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, ChildrenCulled, Stats.NumChildrenCulled, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, ChildrenBelowDrawSize, Stats.NumChildrenBelowDrawSize, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, Layers, Stats.NumLayers, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, StateTransitions, Stats.NumStateTransitions, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, Broadcasts, Stats.NumBroadcasts, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, ArrangeMs, (float)Stats.ArrangeMs, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, PaintMs, (float)Stats.PaintMs, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, DesiredSizeMs, (float)Stats.DesiredSizeMs, ECsvCustomStatOp::Set);
+		CSV_CUSTOM_STAT(UMGExtToggle, BroadcastMs, (float)Stats.BroadcastMs, ECsvCustomStatOp::Set);
+
+		PreviousFrame = CurrentFrame;
+		CurrentFrame.Reset();
+	}
+}
+
+void FMyToggleFrameStats::Reset()
+{
+	NumActiveToggles = 0;
+	NumChildrenArranged = 0;
+	NumChildrenCulled = 0;
+	NumChildrenBelowDrawSize = 0;
+	NumLayers = 0;
+	NumStateTransitions = 0;
+	NumBroadcasts = 0;
+	ArrangeMs = 0.0;
+	PaintMs = 0.0;
+	DesiredSizeMs = 0.0;
+	BroadcastMs = 0.0;
+}
+
+FMyToggleFrameStats& FMyToggleFrameStats::Current()
+{
+	// Toggles only exist once the engine loop runs, hook the frame end on first use.
+	if (!MyToggleFrameStats::EndFrameHandle.IsValid())
+	{
+		MyToggleFrameStats::EndFrameHandle = FCoreDelegates::OnEndFrame.AddStatic(&MyToggleFrameStats::OnEndFrame);
+	}
+
+	return MyToggleFrameStats::CurrentFrame;
+}
+
+const FMyToggleFrameStats& FMyToggleFrameStats::LastFrame()
+{
+	return MyToggleFrameStats::PreviousFrame;
+}
+
+bool FMyToggleFrameStats::IsTimingEnabled()
+{
+#if CSV_PROFILER
+	return MyToggleFrameStats::bTimingForced || FCsvProfiler::Get()->IsCapturing();
+#else
+	return MyToggleFrameStats::bTimingForced;
+#endif
+}
+
+void FMyToggleFrameStats::SetTimingForced(bool bForced)
+{
+	MyToggleFrameStats::bTimingForced = bForced;
+}
+
+/////////////////////////////////////////////////////
+// FMyToggleScopedFrameTimer
+
+FMyToggleScopedFrameTimer::FMyToggleScopedFrameTimer(double& InTargetMs, int32& InDepth)
+	: TargetMs(InTargetMs)
+	, Depth(InDepth)
+	, StartCycles(0)
+{
+	if (Depth++ == 0 && FMyToggleFrameStats::IsTimingEnabled())
+	{
+		StartCycles = FPlatformTime::Cycles64();
+	}
+}
+
+FMyToggleScopedFrameTimer::~FMyToggleScopedFrameTimer()
+{
+	if (--Depth == 0 && StartCycles != 0)
+	{
+		TargetMs += FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - StartCycles);
+	}
+}
@@ -0,0 +1,64 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Per-frame workload of all SMyToggle widgets. Counters are always gathered, timings only while a CSV
+ * capture runs or timing is forced. At the end of each frame the totals are written to the UMGExtToggle
+ * CSV category and kept as the last frame's stats.
+ */
+struct UMGEXTENTIONSAMPLE_API FMyToggleFrameStats
+{
+	/** Toggles painted */
+	int32 NumActiveToggles;
+	int32 NumChildrenArranged;
+	/** Arranged children skipped by paint because they were outside the culling rect */
+	int32 NumChildrenCulled;
+	/** Children not arranged because the toggle was drawn smaller than their minimum draw size */
+	int32 NumChildrenBelowDrawSize;
+	/** Layers started for children in paint */
+	int32 NumLayers;
+	/** Checked state changes, from clicks or from SetToggleIsChecked setting a different state */
+	int32 NumStateTransitions;
+	int32 NumBroadcasts;
+
+	double ArrangeMs;
+	double PaintMs;
+	double DesiredSizeMs;
+	/** Time in ToggleCheckedState, mostly the OnToggleCheckStateChanged handlers */
+	double BroadcastMs;
+
+	FMyToggleFrameStats()
+	{
+		Reset();
+	}
+
+	void Reset();
+
+	/** Stats of the frame in progress. */
+	static FMyToggleFrameStats& Current();
+
+	/** Stats of the previous frame. */
+	static const FMyToggleFrameStats& LastFrame();
+
+	/** Whether toggles should time themselves this frame. */
+	static bool IsTimingEnabled();
+
+	/** Times toggles outside of CSV captures too, e.g. while replaying recorded input. */
+	static void SetTimingForced(bool bForced);
+};
+
+/** Adds the time of the outermost scope to a FMyToggleFrameStats timing, nested toggles aren't counted twice. */
+class UMGEXTENTIONSAMPLE_API FMyToggleScopedFrameTimer
+{
+public:
+	FMyToggleScopedFrameTimer(double& InTargetMs, int32& InDepth);
+	~FMyToggleScopedFrameTimer();
+
+private:
+	double& TargetMs;
+	int32& Depth;
+	uint64 StartCycles;
+};
@@ -0,0 +1,393 @@
+#include "MyToggleInputRecorder.h"
+#include "SMyToggle.h"
+#include "MyToggle.h"
+#include "MyToggleFrameStats.h"
+#include "MyToggleSnapshotLibrary.h"
+#include "Blueprint/UserWidget.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Layout/WidgetPath.h"
+#include "Types/ReflectionMetadata.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Crc.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "UObject/UObjectIterator.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMyToggleInputRecorder, Log, All);
+
+namespace MyToggleInputRecorder
+{
+	static const uint32 FileMagic = 0x52494754; // "TGIR"
+	/** 2: toggle keys hash the path through the containing user widgets. 3: the outermost one by class, not instance name */
+	static const uint32 FileVersion = 3;
+
+	/** Value at the given percentile (0-100) of Samples, sorts them. */
+	static float GetPercentile(TArray<float>& Samples, float Percentile)
+	{
+		if (Samples.Num() == 0)
+		{
+			return 0.0f;
+		}
+
+		Samples.Sort();
+		const int32 Index = FMath::Clamp(FMath::CeilToInt(Samples.Num() * Percentile / 100.0f) - 1, 0, Samples.Num() - 1);
+		return Samples[Index];
+	}
+
+	static void LogPercentiles(const TCHAR* Name, TArray<float>& Samples)
+	{
+		UE_LOG(LogMyToggleInputRecorder, Display, TEXT("  %-10s p50 %7.3f  p90 %7.3f  p99 %7.3f  max %7.3f ms"), Name,
+			GetPercentile(Samples, 50.0f), GetPercentile(Samples, 90.0f), GetPercentile(Samples, 99.0f), GetPercentile(Samples, 100.0f));
+	}
+}
+
+FArchive& operator<<(FArchive& Ar, FMyToggleRecordedInput& Input)
+{
+	uint8 Type = (uint8)Input.Type;
+	Ar << Input.Frame << Input.ToggleKey << Type << Input.KeyIndex << Input.LocalPosition;
+	Input.Type = (EMyToggleInputEvent)Type;
+	return Ar;
+}
+
+bool FMyToggleInputRecorder::bRecording = false;
+
+FMyToggleInputRecorder& FMyToggleInputRecorder::Get()
+{
+	static FMyToggleInputRecorder Recorder;
+	return Recorder;
+}
+
+FMyToggleInputRecorder::FMyToggleInputRecorder()
+	: StartFrame(0)
+	, bReplaying(false)
+	, bExitAfterReplay(false)
+	, NextInput(0)
+	, LastTargetRefreshFrame(0)
+	, NumMissedInputs(0)
+{
+}
+
+uint32 FMyToggleInputRecorder::GetToggleKey(const SMyToggle& Toggle)
+{
+	// UMG tags the widgets it creates with the UWidget they were taken from.
+	TSharedPtr<FReflectionMetaData> MetaData = Toggle.GetMetaData<FReflectionMetaData>();
+	const UWidget* Widget = MetaData.IsValid() ? Cast<UWidget>(MetaData->SourceObject.Get()) : nullptr;
+	if (Widget == nullptr)
+	{
+		return FCrc::StrCrc32(*FReflectionMetaData::GetWidgetDebugInfo(&Toggle));
+	}
+
+	// Through every containing user widget, instances of the same widget blueprint get different keys. The outermost
+	// one is keyed by class, so a replay finds its toggles whatever number of screens were created before it.
+	return UMyToggleSnapshotLibrary::HashWidgetPath(Widget);
+}
+
+void FMyToggleInputRecorder::Record(const SMyToggle& Toggle, EMyToggleInputEvent Type, const FGeometry& Geometry, const FVector2D& ScreenPosition, const FKey& Key)
+{
+	const FVector2D LocalSize = Geometry.GetLocalSize();
+
+	FMyToggleRecordedInput Input;
+	Input.Frame = (uint32)(GFrameCounter - StartFrame);
+	Input.ToggleKey = GetToggleKey(Toggle);
+
+	// Replays can only find one toggle per key.
+	TWeakPtr<SMyToggle>& RecordedToggle = RecordedToggles.FindOrAdd(Input.ToggleKey);
+	TSharedPtr<SMyToggle> OtherToggle = RecordedToggle.Pin();
+	if (OtherToggle.IsValid() && OtherToggle.Get() != &Toggle)
+	{
+		UE_LOG(LogMyToggleInputRecorder, Warning, TEXT("%s has the same key as %s, replayed input may go to the wrong toggle"),
+			*FReflectionMetaData::GetWidgetDebugInfo(&Toggle), *FReflectionMetaData::GetWidgetDebugInfo(OtherToggle.Get()));
+	}
+	RecordedToggle = StaticCastSharedRef<SMyToggle>(ConstCastSharedRef<SWidget>(Toggle.AsShared()));
+	Input.Type = Type;
+	Input.KeyIndex = (uint8)KeyNames.AddUnique(Key.GetFName());
+	Input.LocalPosition = (LocalSize.X > 0.0f && LocalSize.Y > 0.0f)
+		? Geometry.AbsoluteToLocal(ScreenPosition) / LocalSize
+		: FVector2D(0.5f, 0.5f);
+	Inputs.Add(Input);
+}
+
+void FMyToggleInputRecorder::StartRecording()
+{
+	if (bReplaying)
+	{
+		UE_LOG(LogMyToggleInputRecorder, Warning, TEXT("Can't record while replaying"));
+		return;
+	}
+
+	Inputs.Reset();
+	KeyNames.Reset();
+	RecordedToggles.Reset();
+	StartFrame = GFrameCounter;
+	bRecording = true;
+}
+
+bool FMyToggleInputRecorder::StopRecording(const FString& Path)
+{
+	if (!bRecording)
+	{
+		return false;
+	}
+	bRecording = false;
+	RecordedToggles.Reset();
+
+	TArray<uint8> Data;
+	FMemoryWriter Writer(Data);
+
+	uint32 Magic = MyToggleInputRecorder::FileMagic;
+	uint32 Version = MyToggleInputRecorder::FileVersion;
+	TArray<FString> KeyStrings;
+	for (const FName& KeyName : KeyNames)
+	{
+		KeyStrings.Add(KeyName.ToString());
+	}
+	Writer << Magic << Version << KeyStrings << Inputs;
+
+	const bool bSaved = FFileHelper::SaveArrayToFile(Data, *Path);
+	UE_LOG(LogMyToggleInputRecorder, Display, TEXT("%s %d toggle input(s) to %s"), bSaved ? TEXT("Saved") : TEXT("Failed to save"), Inputs.Num(), *Path);
+	return bSaved;
+}
+
+bool FMyToggleInputRecorder::StartReplay(const FString& Path, bool bExitWhenDone)
+{
+	TArray<uint8> Data;
+	if (bRecording || bReplaying || !FFileHelper::LoadFileToArray(Data, *Path))
+	{
+		UE_LOG(LogMyToggleInputRecorder, Warning, TEXT("Can't replay %s"), *Path);
+		return false;
+	}
+
+	FMemoryReader Reader(Data);
+	uint32 Magic = 0;
+	uint32 Version = 0;
+	Reader << Magic << Version;
+	if (Magic != MyToggleInputRecorder::FileMagic || Version != MyToggleInputRecorder::FileVersion)
+	{
+		UE_LOG(LogMyToggleInputRecorder, Warning, TEXT("%s is not a toggle input recording"), *Path);
+		return false;
+	}
+
+	TArray<FString> KeyStrings;
+	Reader << KeyStrings << Inputs;
+
+	KeyNames.Reset();
+	for (const FString& KeyString : KeyStrings)
+	{
+		KeyNames.Add(FName(*KeyString));
+	}
+
+	FrameMs.Reset();
+	ArrangeMs.Reset();
+	PaintMs.Reset();
+	BroadcastMs.Reset();
+	NumMissedInputs = 0;
+	NextInput = 0;
+	ReplayTargets.Reset();
+	LastTargetRefreshFrame = 0;
+
+	StartFrame = GFrameCounter;
+	bExitAfterReplay = bExitWhenDone;
+	bReplaying = true;
+	FMyToggleFrameStats::SetTimingForced(true);
+
+	UE_LOG(LogMyToggleInputRecorder, Display, TEXT("Replaying %d toggle input(s) from %s"), Inputs.Num(), *Path);
+	return true;
+}
+
+void FMyToggleInputRecorder::RefreshReplayTargets()
+{
+	LastTargetRefreshFrame = GFrameCounter;
+	ReplayTargets.Reset();
+
+	for (TObjectIterator<UMyToggle> It; It; ++It)
+	{
+		TSharedPtr<SMyToggle> ToggleWidget = It->GetToggleWidget();
+		if (ToggleWidget.IsValid())
+		{
+			const uint32 Key = GetToggleKey(*ToggleWidget);
+			if (ReplayTargets.Contains(Key))
+			{
+				UE_LOG(LogMyToggleInputRecorder, Warning, TEXT("%s shares its key with another toggle, only one of them gets the replayed input"), *It->GetPathName());
+			}
+			ReplayTargets.Add(Key, ToggleWidget);
+		}
+	}
+}
+
+void FMyToggleInputRecorder::Dispatch(const FMyToggleRecordedInput& Input)
+{
+	TSharedPtr<SMyToggle> Target = ReplayTargets.FindRef(Input.ToggleKey).Pin();
+	if (!Target.IsValid() && LastTargetRefreshFrame != GFrameCounter)
+	{
+		// The screen may have been built since the last lookup.
+		RefreshReplayTargets();
+		Target = ReplayTargets.FindRef(Input.ToggleKey).Pin();
+	}
+
+	if (!Target.IsValid() || !KeyNames.IsValidIndex(Input.KeyIndex))
+	{
+		++NumMissedInputs;
+		return;
+	}
+
+	FSlateApplication& SlateApp = FSlateApplication::Get();
+	const FGeometry& Geometry = Target->GetCachedGeometry();
+	const FVector2D ScreenPosition = Geometry.LocalToAbsolute(Input.LocalPosition * Geometry.GetLocalSize());
+	const FKey Key(KeyNames[Input.KeyIndex]);
+
+	TSet<FKey> PressedButtons;
+	if (Input.Type == EMyToggleInputEvent::MouseDown || Input.Type == EMyToggleInputEvent::DoubleClick)
+	{
+		PressedButtons.Add(Key);
+	}
+	FPointerEvent PointerEvent(FSlateApplicationBase::CursorPointerIndex, ScreenPosition, ScreenPosition, PressedButtons, Key, 0.0f, FModifierKeysState());
+
+	// Button events go through Slate's routing so mouse capture and focus behave as they did when recorded.
+	FWidgetPath WidgetPath;
+	switch (Input.Type)
+	{
+	case EMyToggleInputEvent::MouseDown:
+		if (SlateApp.GeneratePathToWidgetUnchecked(Target.ToSharedRef(), WidgetPath))
+		{
+			SlateApp.RoutePointerDownEvent(WidgetPath, PointerEvent);
+		}
+		break;
+	case EMyToggleInputEvent::MouseUp:
+		if (SlateApp.GeneratePathToWidgetUnchecked(Target.ToSharedRef(), WidgetPath))
+		{
+			SlateApp.RoutePointerUpEvent(WidgetPath, PointerEvent);
+		}
+		break;
+	case EMyToggleInputEvent::DoubleClick:
+		if (SlateApp.GeneratePathToWidgetUnchecked(Target.ToSharedRef(), WidgetPath))
+		{
+			SlateApp.RoutePointerDoubleClickEvent(WidgetPath, PointerEvent);
+		}
+		break;
+	case EMyToggleInputEvent::KeyUp:
+		SlateApp.SetKeyboardFocus(Target, EFocusCause::SetDirectly);
+		SlateApp.ProcessKeyUpEvent(FKeyEvent(Key, FModifierKeysState(), 0, false, 0, 0));
+		break;
+	case EMyToggleInputEvent::MouseEnter:
+		Target->OnMouseEnter(Geometry, PointerEvent);
+		break;
+	case EMyToggleInputEvent::MouseLeave:
+		Target->OnMouseLeave(PointerEvent);
+		break;
+	}
+}
+
+void FMyToggleInputRecorder::Tick(float DeltaTime)
+{
+	const uint32 Frame = (uint32)(GFrameCounter - StartFrame);
+
+	// The previous frame has been painted by now.
+	if (Frame > 0)
+	{
+		const FMyToggleFrameStats& LastFrame = FMyToggleFrameStats::LastFrame();
+		FrameMs.Add(DeltaTime * 1000.0f);
+		ArrangeMs.Add((float)LastFrame.ArrangeMs);
+		PaintMs.Add((float)LastFrame.PaintMs);
+		BroadcastMs.Add((float)LastFrame.BroadcastMs);
+	}
+
+	while (NextInput < Inputs.Num() && Inputs[NextInput].Frame <= Frame)
+	{
+		Dispatch(Inputs[NextInput++]);
+	}
+
+	// Keep going one more frame so the last inputs are painted and measured.
+	if (NextInput >= Inputs.Num() && (Inputs.Num() == 0 || Frame > Inputs.Last().Frame + 1))
+	{
+		FinishReplay();
+	}
+}
+
+void FMyToggleInputRecorder::FinishReplay()
+{
+	bReplaying = false;
+	FMyToggleFrameStats::SetTimingForced(false);
+
+	UE_LOG(LogMyToggleInputRecorder, Display, TEXT("Replayed %d toggle input(s) over %d frame(s), %d without a matching toggle"),
+		Inputs.Num(), FrameMs.Num(), NumMissedInputs);
+	MyToggleInputRecorder::LogPercentiles(TEXT("Frame"), FrameMs);
+	MyToggleInputRecorder::LogPercentiles(TEXT("Arrange"), ArrangeMs);
+	MyToggleInputRecorder::LogPercentiles(TEXT("Paint"), PaintMs);
+	MyToggleInputRecorder::LogPercentiles(TEXT("Broadcast"), BroadcastMs);
+
+	ReplayTargets.Reset();
+
+	if (bExitAfterReplay)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+bool FMyToggleInputRecorder::IsTickable() const
+{
+	return bReplaying;
+}
+
+bool FMyToggleInputRecorder::IsTickableWhenPaused() const
+{
+	return true;
+}
+
+TStatId FMyToggleInputRecorder::GetStatId() const
+{
+	RETURN_QUICK_DECLARE_CYCLE_STAT(FMyToggleInputRecorder, STATGROUP_Tickables);
+}
+
+namespace MyToggleInputRecorder
+{
+	static FString GetDefaultPath()
+	{
+		return FPaths::ProjectSavedDir() / TEXT("ToggleInput.bin");
+	}
+
+	static void RecordCommand(const TArray<FString>& Args)
+	{
+		if (Args.Num() > 0 && Args[0] == TEXT("Stop"))
+		{
+			FMyToggleInputRecorder::Get().StopRecording(Args.Num() > 1 ? Args[1] : GetDefaultPath());
+		}
+		else
+		{
+			FMyToggleInputRecorder::Get().StartRecording();
+		}
+	}
+
+	static void ReplayCommand(const TArray<FString>& Args)
+	{
+		FString Path = GetDefaultPath();
+		bool bExit = false;
+		for (const FString& Arg : Args)
+		{
+			if (Arg == TEXT("-exit"))
+			{
+				bExit = true;
+			}
+			else
+			{
+				Path = Arg;
+			}
+		}
+
+		if (!FMyToggleInputRecorder::Get().StartReplay(Path, bExit) && bExit)
+		{
+			FPlatformMisc::RequestExit(false);
+		}
+	}
+
+	static FAutoConsoleCommand RecordInputCommand(
+		TEXT("UMGExt.Toggle.RecordInput"),
+		TEXT("Records the input events delivered to toggles. Args: Start | Stop [Path]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&RecordCommand));
+
+	static FAutoConsoleCommand ReplayInputCommand(
+		TEXT("UMGExt.Toggle.ReplayInput"),
+		TEXT("Replays recorded toggle input and reports arrange, paint and broadcast time percentiles. Args: [Path] [-exit]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&ReplayCommand));
+}
@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Tickable.h"
+#include "InputCoreTypes.h"
+
+class SMyToggle;
+struct FGeometry;
+
+/** Kind of input event delivered to an SMyToggle. */
+enum class EMyToggleInputEvent : uint8
+{
+	MouseDown,
+	MouseUp,
+	DoubleClick,
+	KeyUp,
+	MouseEnter,
+	MouseLeave,
+};
+
+/** One recorded input event, positions are relative to the toggle's size so replays survive resolution changes. */
+struct FMyToggleRecordedInput
+{
+	/** Frames since the recording started */
+	uint32 Frame;
+	/** See FMyToggleInputRecorder::GetToggleKey */
+	uint32 ToggleKey;
+	EMyToggleInputEvent Type;
+	/** Index of the mouse button or key in the recording's key names */
+	uint8 KeyIndex;
+	FVector2D LocalPosition;
+
+	friend FArchive& operator<<(FArchive& Ar, FMyToggleRecordedInput& Input);
+};
+
+/**
+ * Records the pointer and key events delivered to SMyToggle widgets into a compact file, and replays
+ * them against the same widget tree frame for frame while timing arrange, paint and broadcast.
+ * Run headless with: -nullrhi -ExecCmds="UMGExt.Toggle.ReplayInput <File> -exit"
+ */
+class UMGEXTENTIONSAMPLE_API FMyToggleInputRecorder : public FTickableGameObject
+{
+public:
+	static FMyToggleInputRecorder& Get();
+
+	static bool IsRecording()
+	{
+		return bRecording;
+	}
+
+	/** Called by SMyToggle for every event it receives while recording. */
+	void Record(const SMyToggle& Toggle, EMyToggleInputEvent Type, const FGeometry& Geometry, const FVector2D& ScreenPosition, const FKey& Key);
+
+	void StartRecording();
+	bool StopRecording(const FString& Path);
+
+	bool StartReplay(const FString& Path, bool bExitWhenDone);
+
+	/** Stable identity of a toggle across runs: a hash of its UMG widget path through all containing user widgets. */
+	static uint32 GetToggleKey(const SMyToggle& Toggle);
+
+	// Begin FTickableGameObject
+	virtual void Tick(float DeltaTime) override;
+	virtual bool IsTickable() const override;
+	virtual bool IsTickableWhenPaused() const override;
+	virtual TStatId GetStatId() const override;
+	// End FTickableGameObject
+
+private:
+	FMyToggleInputRecorder();
+
+	void RefreshReplayTargets();
+	void Dispatch(const FMyToggleRecordedInput& Input);
+	void FinishReplay();
+
+	static bool bRecording;
+
+	uint64 StartFrame;
+	TArray<FName> KeyNames;
+	TArray<FMyToggleRecordedInput> Inputs;
+	/** Toggle last recorded per key, to report toggles a replay can't tell apart */
+	TMap<uint32, TWeakPtr<SMyToggle>> RecordedToggles;
+
+	bool bReplaying;
+	bool bExitAfterReplay;
+	int32 NextInput;
+	uint64 LastTargetRefreshFrame;
+	TMap<uint32, TWeakPtr<SMyToggle>> ReplayTargets;
+
+	/** Per replayed frame timings, in ms */
+	TArray<float> FrameMs;
+	TArray<float> ArrangeMs;
+	TArray<float> PaintMs;
+	TArray<float> BroadcastMs;
+	int32 NumMissedInputs;
+};
@@ -0,0 +1,191 @@
+#include "MyToggleLatency.h"
+#include "SMyToggle.h"
+#include "HAL/IConsoleManager.h"
+#include "Types/ReflectionMetadata.h"
+
+DEFINE_STAT(STAT_MyToggleInputToBroadcast);
+DEFINE_STAT(STAT_MyToggleInputToPaint);
+DEFINE_STAT(STAT_MyToggleLatencyOverBudget);
+
+DEFINE_LOG_CATEGORY_STATIC(LogMyToggleLatency, Log, All);
+
+static int32 GMyToggleTrackLatency = 0;
+static FAutoConsoleVariableRef CVarMyToggleTrackLatency(
+	TEXT("UMGExt.Toggle.TrackLatency"),
+	GMyToggleTrackLatency,
+	TEXT("Measures the time from a toggle click to its broadcast and to the first paint of the new state."));
+
+static float GMyToggleLatencyBudgetMs = 0.0f;
+static FAutoConsoleVariableRef CVarMyToggleLatencyBudgetMs(
+	TEXT("UMGExt.Toggle.LatencyBudgetMs"),
+	GMyToggleLatencyBudgetMs,
+	TEXT("Input to paint time in milliseconds above which a toggle click is logged and counted as over budget, 0 disables."));
+
+static float GMyToggleLatencyPaintTimeoutMs = 10000.0f;
+static FAutoConsoleVariableRef CVarMyToggleLatencyPaintTimeoutMs(
+	TEXT("UMGExt.Toggle.LatencyPaintTimeoutMs"),
+	GMyToggleLatencyPaintTimeoutMs,
+	TEXT("Time in milliseconds a toggle waits for its new state to paint before dropping the sample, e.g. when a binding rejected the click."));
+
+/////////////////////////////////////////////////////
+// FMyToggleLatencyHistogram
+
+void FMyToggleLatencyHistogram::Reset()
+{
+	FMemory::Memzero(Buckets);
+	NumSamples = 0;
+	TotalMs = 0.0;
+	MaxMs = 0.0;
+}
+
+void FMyToggleLatencyHistogram::AddSample(double Ms)
+{
+	const int32 Bucket = FMath::Clamp((int32)Ms, 0, NumBuckets - 1);
+	++Buckets[Bucket];
+	++NumSamples;
+	TotalMs += Ms;
+	MaxMs = FMath::Max(MaxMs, Ms);
+}
+
+double FMyToggleLatencyHistogram::GetPercentile(double Percentile) const
+{
+	if (NumSamples == 0)
+	{
+		return 0.0;
+	}
+
+	const uint32 Target = FMath::Max<uint32>(1, (uint32)FMath::CeilToInt(NumSamples * FMath::Clamp(Percentile, 0.0, 100.0) / 100.0));
+	uint32 Count = 0;
+	for (int32 Bucket = 0; Bucket < NumBuckets - 1; ++Bucket)
+	{
+		Count += Buckets[Bucket];
+		if (Count >= Target)
+		{
+			return FMath::Min<double>(Bucket + 1, MaxMs);
+		}
+	}
+
+	return MaxMs;
+}
+
+/////////////////////////////////////////////////////
+// FMyToggleLatencyTracker
+
+FMyToggleLatencyTracker& FMyToggleLatencyTracker::Get()
+{
+	static FMyToggleLatencyTracker Tracker;
+	return Tracker;
+}
+
+FMyToggleLatencyTracker::FMyToggleLatencyTracker()
+	: NumOverBudget(0)
+{
+}
+
+bool FMyToggleLatencyTracker::IsEnabled()
+{
+	return GMyToggleTrackLatency != 0;
+}
+
+double FMyToggleLatencyTracker::GetPaintTimeout()
+{
+	return GMyToggleLatencyPaintTimeoutMs / 1000.0;
+}
+
+FMyToggleLatencyTracker::FToggleLatency& FMyToggleLatencyTracker::FindOrAddToggle(const SMyToggle& Toggle)
+{
+	FToggleLatency& Entry = Toggles.FindOrAdd(&Toggle);
+
+	// A new toggle may have been allocated where a destroyed one was.
+	if (!Entry.Widget.IsValid())
+	{
+		Entry.Widget = Toggle.AsShared();
+		Entry.Label = FReflectionMetaData::GetWidgetDebugInfo(&Toggle);
+		Entry.InputToBroadcast.Reset();
+		Entry.InputToPaint.Reset();
+	}
+
+	return Entry;
+}
+
+void FMyToggleLatencyTracker::RecordBroadcast(const SMyToggle& Toggle, double InputTime, double BroadcastTime)
+{
+	const double Ms = (BroadcastTime - InputTime) * 1000.0;
+	InputToBroadcast.AddSample(Ms);
+	FindOrAddToggle(Toggle).InputToBroadcast.AddSample(Ms);
+
+	SET_FLOAT_STAT(STAT_MyToggleInputToBroadcast, Ms);
+}
+
+void FMyToggleLatencyTracker::RecordPaint(const SMyToggle& Toggle, double InputTime, double PaintTime)
+{
+	const double Ms = (PaintTime - InputTime) * 1000.0;
+	InputToPaint.AddSample(Ms);
+	FToggleLatency& Entry = FindOrAddToggle(Toggle);
+	Entry.InputToPaint.AddSample(Ms);
+
+	SET_FLOAT_STAT(STAT_MyToggleInputToPaint, Ms);
+
+	if (GMyToggleLatencyBudgetMs > 0.0f && Ms > GMyToggleLatencyBudgetMs)
+	{
+		++NumOverBudget;
+		INC_DWORD_STAT(STAT_MyToggleLatencyOverBudget);
+		UE_LOG(LogMyToggleLatency, Warning, TEXT("%s took %.2f ms from input to paint, budget is %.2f ms"), *Entry.Label, Ms, GMyToggleLatencyBudgetMs);
+	}
+}
+
+void FMyToggleLatencyTracker::ReportHistogram(FOutputDevice& Ar, const TCHAR* Name, const FMyToggleLatencyHistogram& Histogram)
+{
+	Ar.Logf(TEXT("    %-20s samples %6u  avg %7.2f  p50 %6.1f  p95 %6.1f  p99 %6.1f  max %7.2f ms"),
+		Name, Histogram.NumSamples, Histogram.GetAverage(),
+		Histogram.GetPercentile(50.0), Histogram.GetPercentile(95.0), Histogram.GetPercentile(99.0), Histogram.MaxMs);
+}
+
+void FMyToggleLatencyTracker::Report(FOutputDevice& Ar)
+{
+	Ar.Logf(TEXT("Toggle latency, %d sample(s) over the %.2f ms budget"), NumOverBudget, GMyToggleLatencyBudgetMs);
+	Ar.Logf(TEXT("  All toggles"));
+	ReportHistogram(Ar, TEXT("Input to broadcast"), InputToBroadcast);
+	ReportHistogram(Ar, TEXT("Input to paint"), InputToPaint);
+
+	for (const TPair<const SMyToggle*, FToggleLatency>& Pair : Toggles)
+	{
+		const FToggleLatency& Entry = Pair.Value;
+		Ar.Logf(TEXT("  %s%s"), *Entry.Label, Entry.Widget.IsValid() ? TEXT("") : TEXT(" (destroyed)"));
+		ReportHistogram(Ar, TEXT("Input to broadcast"), Entry.InputToBroadcast);
+		ReportHistogram(Ar, TEXT("Input to paint"), Entry.InputToPaint);
+	}
+
+	// Entries are keyed by address, drop the destroyed ones once reported so the map doesn't grow with every toggle ever clicked.
+	for (auto It = Toggles.CreateIterator(); It; ++It)
+	{
+		if (!It.Value().Widget.IsValid())
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+void FMyToggleLatencyTracker::Reset()
+{
+	InputToBroadcast.Reset();
+	InputToPaint.Reset();
+	Toggles.Reset();
+	NumOverBudget = 0;
+}
+
+static void MyToggleLatencyReport(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+{
+	FMyToggleLatencyTracker& Tracker = FMyToggleLatencyTracker::Get();
+	Tracker.Report(Ar);
+
+	if (Args.Num() > 0 && Args[0] == TEXT("Reset"))
+	{
+		Tracker.Reset();
+	}
+}
+
+static FAutoConsoleCommandWithWorldArgsAndOutputDevice MyToggleLatencyReportCommand(
+	TEXT("UMGExt.Toggle.LatencyReport"),
+	TEXT("Dumps toggle input latency histograms recorded with UMGExt.Toggle.TrackLatency. Args: [Reset]"),
+	FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&MyToggleLatencyReport));
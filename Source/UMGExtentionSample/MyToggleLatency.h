@@ -0,0 +1,91 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+
+class SMyToggle;
+class SWidget;
+
+DECLARE_STATS_GROUP(TEXT("UMGExt Toggle"), STATGROUP_UMGExtToggle, STATCAT_Advanced);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Input To Broadcast (ms)"), STAT_MyToggleInputToBroadcast, STATGROUP_UMGExtToggle, UMGEXTENTIONSAMPLE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Input To Paint (ms)"), STAT_MyToggleInputToPaint, STATGROUP_UMGExtToggle, UMGEXTENTIONSAMPLE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Latency Over Budget"), STAT_MyToggleLatencyOverBudget, STATGROUP_UMGExtToggle, UMGEXTENTIONSAMPLE_API);
+
+/** Latency samples in 1 ms buckets, with a last bucket for everything slower. */
+struct UMGEXTENTIONSAMPLE_API FMyToggleLatencyHistogram
+{
+	enum { NumBuckets = 101 };
+
+	uint32 Buckets[NumBuckets];
+	uint32 NumSamples;
+	double TotalMs;
+	double MaxMs;
+
+	FMyToggleLatencyHistogram()
+	{
+		Reset();
+	}
+
+	void Reset();
+	void AddSample(double Ms);
+
+	/** Upper bound of the bucket holding the given percentile (0-100) of the samples, in ms. */
+	double GetPercentile(double Percentile) const;
+
+	double GetAverage() const
+	{
+		return NumSamples > 0 ? TotalMs / NumSamples : 0.0;
+	}
+};
+
+/**
+ * Measures how long toggle clicks take to show on screen while UMGExt.Toggle.TrackLatency is on:
+ * from the input event to the state change broadcast, and to the first paint drawing the new state.
+ * Samples are published as stats (stat UMGExtToggle) and gathered in histograms per toggle and overall,
+ * dumped by UMGExt.Toggle.LatencyReport. Samples over UMGExt.Toggle.LatencyBudgetMs are counted and logged.
+ */
+class UMGEXTENTIONSAMPLE_API FMyToggleLatencyTracker
+{
+public:
+	static FMyToggleLatencyTracker& Get();
+
+	/** Whether toggles should time their clicks, checked by SMyToggle before taking timestamps. */
+	static bool IsEnabled();
+
+	/** Seconds after which a click whose new state never painted is dropped, see UMGExt.Toggle.LatencyPaintTimeoutMs. */
+	static double GetPaintTimeout();
+
+	void RecordBroadcast(const SMyToggle& Toggle, double InputTime, double BroadcastTime);
+	void RecordPaint(const SMyToggle& Toggle, double InputTime, double PaintTime);
+
+	/** Writes the histograms, then forgets the toggles that were destroyed since. */
+	void Report(FOutputDevice& Ar);
+	void Reset();
+
+	int32 GetNumOverBudget() const
+	{
+		return NumOverBudget;
+	}
+
+private:
+	struct FToggleLatency
+	{
+		TWeakPtr<const SWidget> Widget;
+		FString Label;
+		FMyToggleLatencyHistogram InputToBroadcast;
+		FMyToggleLatencyHistogram InputToPaint;
+	};
+
+	FMyToggleLatencyTracker();
+
+	FToggleLatency& FindOrAddToggle(const SMyToggle& Toggle);
+
+	static void ReportHistogram(FOutputDevice& Ar, const TCHAR* Name, const FMyToggleLatencyHistogram& Histogram);
+
+	FMyToggleLatencyHistogram InputToBroadcast;
+	FMyToggleLatencyHistogram InputToPaint;
+	TMap<const SMyToggle*, FToggleLatency> Toggles;
+	int32 NumOverBudget;
+};
@@ -0,0 +1,99 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/Margin.h"
+#include "Layout/Geometry.h"
+#include "Widgets/SWidget.h"
+#include "Widgets/Layout/Anchors.h"
+
+/**
+ * Anchor/offset slot math shared by the panels of this module.
+ * SlotType needs OffsetAttr, AnchorsAttr, AlignmentAttr and AutoSizeAttr, like SMyToggle::FSlot.
+ */
+namespace MyToggleLayout
+{
+	/** Computes the local position and size of a slot inside a parent of the given local size. */
+	template<typename SlotType>
+	FORCEINLINE void ArrangeSlot(const FVector2D& LocalSizeGeometry, const SlotType& Slot, FVector2D& OutLocalPosition, FVector2D& OutLocalSize)
+	{
+		const FMargin& Offset = Slot.OffsetAttr.Get();
+		const FVector2D& Alignment = Slot.AlignmentAttr.Get();
+		const FAnchors& Anchors = Slot.AnchorsAttr.Get();
+		const bool AutoSize = Slot.AutoSizeAttr.Get();
+
+		const FMargin AnchorPixels = FMargin(
+			Anchors.Minimum.X * LocalSizeGeometry.X,
+			Anchors.Minimum.Y * LocalSizeGeometry.Y,
+			Anchors.Maximum.X * LocalSizeGeometry.X,
+			Anchors.Maximum.Y * LocalSizeGeometry.Y);
+
+		bool bIsHorizontalStretch = Anchors.Minimum.X != Anchors.Maximum.X;
+		bool bIsVerticalStretch = Anchors.Minimum.Y != Anchors.Maximum.Y;
+		FVector2D SlotSize(Offset.Right, Offset.Bottom);
+		FVector2D Size = AutoSize ? Slot.GetWidget()->GetDesiredSize() : SlotSize;
+		FVector2D AlignmentOffset = Size * Alignment;
+
+		if (bIsHorizontalStretch)
+		{
+			OutLocalPosition.X = AnchorPixels.Left + Offset.Left;
+			OutLocalSize.X = AnchorPixels.Right - OutLocalPosition.X - Offset.Right;
+		}
+		else
+		{
+			OutLocalPosition.X = AnchorPixels.Left + Offset.Left - AlignmentOffset.X;
+			OutLocalSize.X = Size.X;
+		}
+
+		if (bIsVerticalStretch)
+		{
+			OutLocalPosition.Y = AnchorPixels.Top + Offset.Top;
+			OutLocalSize.Y = AnchorPixels.Bottom - OutLocalPosition.Y - Offset.Bottom;
+		}
+		else
+		{
+			OutLocalPosition.Y = AnchorPixels.Top + Offset.Top - AlignmentOffset.Y;
+			OutLocalSize.Y = Size.Y;
+		}
+	}
+
+	/** Grows DesiredSize so that it contains the slot, the same way a canvas panel does. */
+	template<typename SlotType>
+	FORCEINLINE void AccumulateDesiredSize(const SlotType& Slot, FVector2D& DesiredSize)
+	{
+		const FMargin Offset = Slot.OffsetAttr.Get();
+		const FAnchors Anchors = Slot.AnchorsAttr.Get();
+
+		const FVector2D SlotSize = FVector2D(Offset.Right, Offset.Bottom);
+
+		const bool AutoSize = Slot.AutoSizeAttr.Get();
+
+		const FVector2D Size = AutoSize ? Slot.GetWidget()->GetDesiredSize() : SlotSize;
+
+		const bool bIsDockedHorizontally = (Anchors.Minimum.X == Anchors.Maximum.X) && (Anchors.Minimum.X == 0 || Anchors.Minimum.X == 1);
+		const bool bIsDockedVertically = (Anchors.Minimum.Y == Anchors.Maximum.Y) && (Anchors.Minimum.Y == 0 || Anchors.Minimum.Y == 1);
+
+		DesiredSize.X = FMath::Max(DesiredSize.X, Size.X + (bIsDockedHorizontally ? FMath::Abs(Offset.Left) : 0.0f));
+		DesiredSize.Y = FMath::Max(DesiredSize.Y, Size.Y + (bIsDockedVertically ? FMath::Abs(Offset.Top) : 0.0f));
+	}
+
+	/** Whether moving the slot from OldOffset to its current offset changes what it adds in AccumulateDesiredSize. */
+	template<typename SlotType>
+	FORCEINLINE bool DoesOffsetChangeDesiredSize(const SlotType& Slot, const FMargin& OldOffset)
+	{
+		const FMargin NewOffset = Slot.OffsetAttr.Get();
+		const FAnchors Anchors = Slot.AnchorsAttr.Get();
+		const bool bIsDockedHorizontally = (Anchors.Minimum.X == Anchors.Maximum.X) && (Anchors.Minimum.X == 0 || Anchors.Minimum.X == 1);
+		const bool bIsDockedVertically = (Anchors.Minimum.Y == Anchors.Maximum.Y) && (Anchors.Minimum.Y == 0 || Anchors.Minimum.Y == 1);
+
+		bool bDesiredSizeChanged = false;
+		if (!Slot.AutoSizeAttr.Get())
+		{
+			bDesiredSizeChanged |= OldOffset.Right != NewOffset.Right || OldOffset.Bottom != NewOffset.Bottom;
+		}
+		bDesiredSizeChanged |= bIsDockedHorizontally && FMath::Abs(OldOffset.Left) != FMath::Abs(NewOffset.Left);
+		bDesiredSizeChanged |= bIsDockedVertically && FMath::Abs(OldOffset.Top) != FMath::Abs(NewOffset.Top);
+		return bDesiredSizeChanged;
+	}
+}
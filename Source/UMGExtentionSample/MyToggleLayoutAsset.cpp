@@ -0,0 +1,122 @@
+#include "MyToggleLayoutAsset.h"
+#include "SMyToggle.h"
+#include "MyTogglePrefetch.h"
+#include "Widgets/Images/SImage.h"
+#include "Widgets/Text/STextBlock.h"
+#include "UObject/UObjectIterator.h"
+#include "MyToggle.h"
+
+/////////////////////////////////////////////////////
+// FMyToggleLayoutEntry
+
+FMyToggleLayoutEntry::FMyToggleLayoutEntry()
+	: bAutoSize(false)
+	, ZOrder(0)
+	, SlotType(EToggleSlotType::Other)
+	, StateMask((int32)EToggleStateFlags::All)
+	, MinimumDrawSize(0.0f)
+	, ContentType(EMyToggleLayoutContent::Image)
+	, ColorAndOpacity(FLinearColor::White)
+{
+	LayoutData.Offsets = FMargin(0, 0, 100, 30);
+	LayoutData.Anchors = FAnchors(0.0f, 0.0f);
+	LayoutData.Alignment = FVector2D(0.0f, 0.0f);
+}
+
+/////////////////////////////////////////////////////
+// UMyToggleLayoutAsset
+
+UMyToggleLayoutAsset::UMyToggleLayoutAsset(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+void UMyToggleLayoutAsset::BuildSlots(TSharedRef<SMyToggle> Toggle) const
+{
+	if (EntryBrushes.Num() < Entries.Num())
+	{
+		UpdateEntryBrushes();
+	}
+
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		const FMyToggleLayoutEntry& Entry = Entries[EntryIndex];
+		Toggle->AddSlot()
+			.Offset(Entry.LayoutData.Offsets)
+			.Anchors(Entry.LayoutData.Anchors)
+			.Alignment(Entry.LayoutData.Alignment)
+			.AutoSize(Entry.bAutoSize)
+			.ZOrder(Entry.ZOrder)
+			.SlotType(Entry.SlotType)
+			.StateMask((uint8)Entry.StateMask)
+			.MinDrawSize(Entry.MinimumDrawSize)
+			[
+				MakeContent(EntryIndex)
+			];
+	}
+}
+
+void UMyToggleLayoutAsset::RequestResources(uint8 StateMask, float ResidentSeconds) const
+{
+	for (const FMyToggleLayoutEntry& Entry : Entries)
+	{
+		if (Entry.ContentType == EMyToggleLayoutContent::Image && (ToggleSlotTypeToStateMask(Entry.SlotType, (uint8)Entry.StateMask) & StateMask) != 0)
+		{
+			MyTogglePrefetch::RequestBrushResources(Entry.Brush, ResidentSeconds);
+		}
+	}
+}
+
+void UMyToggleLayoutAsset::UpdateEntryBrushes() const
+{
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		if (EntryBrushes.IsValidIndex(EntryIndex))
+		{
+			EntryBrushes[EntryIndex] = Entries[EntryIndex].Brush;
+		}
+		else
+		{
+			EntryBrushes.Add(new FSlateBrush(Entries[EntryIndex].Brush));
+		}
+	}
+}
+
+TSharedRef<SWidget> UMyToggleLayoutAsset::MakeContent(int32 EntryIndex) const
+{
+	const FMyToggleLayoutEntry& Entry = Entries[EntryIndex];
+	switch (Entry.ContentType)
+	{
+	case EMyToggleLayoutContent::Text:
+		return SNew(STextBlock)
+			.Text(Entry.Text)
+			.Font(Entry.Font)
+			.ColorAndOpacity(Entry.ColorAndOpacity);
+	case EMyToggleLayoutContent::Image:
+	default:
+		return SNew(SImage)
+			.Image(&EntryBrushes[EntryIndex])
+			.ColorAndOpacity(Entry.ColorAndOpacity);
+	}
+}
+
+#if WITH_EDITOR
+
+void UMyToggleLayoutAsset::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	// Images not rebuilt below keep drawing valid brushes, the edited ones.
+	UpdateEntryBrushes();
+
+	// Toggles built from the asset keep copies of the old entries.
+	for (TObjectIterator<UMyToggle> It; It; ++It)
+	{
+		if (It->LayoutAsset == this && !It->IsTemplate())
+		{
+			It->RebuildLayoutSlots();
+		}
+	}
+}
+
+#endif
@@ -0,0 +1,109 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Engine/DataAsset.h"
+#include "Styling/SlateBrush.h"
+#include "Styling/SlateColor.h"
+#include "Fonts/SlateFontInfo.h"
+#include "Components/CanvasPanelSlot.h"
+#include "UMGExtensionDefine.h"
+#include "MyToggleLayoutAsset.generated.h"
+
+class SMyToggle;
+class SWidget;
+
+UENUM(BlueprintType)
+enum class EMyToggleLayoutContent : uint8
+{
+	/** Draws the entry's brush */
+	Image,
+	/** Draws the entry's text */
+	Text,
+};
+
+/** One decoration of a toggle, the UObject-free equivalent of a UMyToggleSlot and its content. */
+USTRUCT(BlueprintType)
+struct UMGEXTENTIONSAMPLE_API FMyToggleLayoutEntry
+{
+	GENERATED_USTRUCT_BODY()
+
+	/** The anchoring information for the slot */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout")
+	FAnchorData LayoutData;
+
+	/** When AutoSize is true we use the widget's desired size */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout", meta = (DisplayName = "Size To Content"))
+	bool bAutoSize;
+
+	/** The order priority this widget is rendered in.  Higher values are rendered last (and so they will appear to be on top). */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout")
+	int32 ZOrder;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout")
+	EToggleSlotType SlotType;
+
+	/** The check states this slot is shown in when SlotType is Masked */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout", meta = (Bitmask, BitmaskEnum = "EToggleStateFlags", EditCondition = "SlotType == EToggleSlotType::Masked"))
+	int32 StateMask;
+
+	/** Smallest on-screen size, in pixels of the toggle's shorter side, the entry is still drawn at. 0 always draws it. */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout", meta = (ClampMin = "0"))
+	float MinimumDrawSize;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content")
+	EMyToggleLayoutContent ContentType;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content", meta = (EditCondition = "ContentType == EMyToggleLayoutContent::Image"))
+	FSlateBrush Brush;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content", meta = (EditCondition = "ContentType == EMyToggleLayoutContent::Text"))
+	FText Text;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content", meta = (EditCondition = "ContentType == EMyToggleLayoutContent::Text"))
+	FSlateFontInfo Font;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Content")
+	FSlateColor ColorAndOpacity;
+
+	FMyToggleLayoutEntry();
+};
+
+/**
+ * Slot layout of a toggle stored as plain data. UMyToggle builds SMyToggle children straight from it,
+ * so a toggle using a layout asset costs no UMyToggleSlot or content UObjects per decoration.
+ */
+UCLASS(BlueprintType)
+class UMGEXTENTIONSAMPLE_API UMyToggleLayoutAsset : public UDataAsset
+{
+	GENERATED_UCLASS_BODY()
+public:
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout")
+	TArray<FMyToggleLayoutEntry> Entries;
+
+public:
+	/** Adds one child to the toggle per entry. The children copy what they need from the entries. */
+	void BuildSlots(TSharedRef<SMyToggle> Toggle) const;
+
+	/** Requests the textures of the entries shown in the states of StateMask, see MyTogglePrefetch. */
+	void RequestResources(uint8 StateMask, float ResidentSeconds) const;
+
+#if WITH_EDITOR
+	/** Rebuilds the toggles using the asset, so they show the edited entries. */
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	/** Copies the entries' brushes to EntryBrushes, growing it when entries were added. */
+	void UpdateEntryBrushes() const;
+
+	TSharedRef<SWidget> MakeContent(int32 EntryIndex) const;
+
+	/**
+	 * Brushes drawn by the images of every toggle built from the asset, one per entry. Entries move whenever the array
+	 * is resized, these don't: they are overwritten in place on edit and never freed before the asset.
+	 */
+	mutable TIndirectArray<FSlateBrush> EntryBrushes;
+};
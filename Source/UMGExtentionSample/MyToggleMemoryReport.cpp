@@ -0,0 +1,229 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/FileManager.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Misc/Parse.h"
+#include "UObject/UObjectIterator.h"
+#include "Components/PanelWidget.h"
+#include "Widgets/SNullWidget.h"
+#include "SMyToggle.h"
+#include "MyToggle.h"
+
+namespace MyToggleMemoryReport
+{
+	enum { NumSlotTypes = (int32)EToggleSlotType::Masked + 1 };
+
+	struct FToggleMemory
+	{
+		FString Name;
+		int32 NumSlots;
+		SIZE_T SlotStorage;
+		/** Widget subtrees of the slots, by slot type */
+		SIZE_T ChildWidgets[NumSlotTypes];
+		/** Part of ChildWidgets not shown in the current state */
+		SIZE_T InactiveChildWidgets;
+		SIZE_T SlotObjects;
+
+		FToggleMemory()
+			: NumSlots(0)
+			, SlotStorage(0)
+			, InactiveChildWidgets(0)
+			, SlotObjects(0)
+		{
+			FMemory::Memzero(ChildWidgets);
+		}
+
+		SIZE_T GetTotal() const
+		{
+			SIZE_T Total = SlotStorage + SlotObjects;
+			for (SIZE_T Size : ChildWidgets)
+			{
+				Total += Size;
+			}
+			return Total;
+		}
+
+		void Accumulate(const FToggleMemory& Other)
+		{
+			NumSlots += Other.NumSlots;
+			SlotStorage += Other.SlotStorage;
+			for (int32 Type = 0; Type < NumSlotTypes; ++Type)
+			{
+				ChildWidgets[Type] += Other.ChildWidgets[Type];
+			}
+			InactiveChildWidgets += Other.InactiveChildWidgets;
+			SlotObjects += Other.SlotObjects;
+		}
+	};
+
+	/**
+	 * Lower bound of the bytes of a widget and its descendants, sizeof(SWidget) per widget. The allocator can't be asked,
+	 * widgets made with MakeShared live inside their reference controller. Widgets already in Visited and the shared
+	 * null widget are not counted.
+	 */
+	static SIZE_T GetWidgetTreeSize(SWidget& Widget, TSet<const SWidget*>& Visited)
+	{
+		bool bAlreadyVisited = false;
+		Visited.Add(&Widget, &bAlreadyVisited);
+		if (bAlreadyVisited || &Widget == &SNullWidget::NullWidget.Get())
+		{
+			return 0;
+		}
+
+		SIZE_T Size = sizeof(SWidget);
+		FChildren* Children = Widget.GetChildren();
+		for (int32 ChildIndex = 0; ChildIndex < Children->Num(); ++ChildIndex)
+		{
+			Size += GetWidgetTreeSize(*Children->GetChildAt(ChildIndex), Visited);
+		}
+		return Size;
+	}
+
+	/** Bytes of a UMG widget object and, for panels, of its slots and children. */
+	static SIZE_T GetWidgetObjectSize(const UWidget* Widget)
+	{
+		if (Widget == nullptr)
+		{
+			return 0;
+		}
+
+		SIZE_T Size = Widget->GetClass()->GetStructureSize();
+		if (const UPanelWidget* Panel = Cast<UPanelWidget>(Widget))
+		{
+			for (const UPanelSlot* PanelSlot : Panel->GetSlots())
+			{
+				Size += PanelSlot ? PanelSlot->GetClass()->GetStructureSize() : 0;
+				Size += PanelSlot ? GetWidgetObjectSize(PanelSlot->Content) : 0;
+			}
+		}
+		return Size;
+	}
+
+	static FToggleMemory MeasureToggle(UMyToggle* Toggle)
+	{
+		FToggleMemory Memory;
+		Memory.Name = Toggle->GetPathName();
+
+		for (const UPanelSlot* PanelSlot : Toggle->GetSlots())
+		{
+			if (PanelSlot)
+			{
+				Memory.SlotObjects += PanelSlot->GetClass()->GetStructureSize() + GetWidgetObjectSize(PanelSlot->Content);
+			}
+		}
+
+		TSharedPtr<SMyToggle> ToggleWidget = Toggle->GetToggleWidget();
+		if (ToggleWidget.IsValid())
+		{
+			Memory.NumSlots = ToggleWidget->NumSlots();
+			Memory.SlotStorage = ToggleWidget->GetSlotStorageSize();
+
+			TSet<const SWidget*> Visited;
+			for (int32 SlotIndex = 0; SlotIndex < ToggleWidget->NumSlots(); ++SlotIndex)
+			{
+				const SMyToggle::FSlot& ToggleSlot = ToggleWidget->GetSlot(SlotIndex);
+				const SIZE_T WidgetSize = GetWidgetTreeSize(ToggleSlot.GetWidget().Get(), Visited);
+				const int32 Type = FMath::Clamp((int32)ToggleSlot.SlotTypeAttr.Get(), 0, NumSlotTypes - 1);
+
+				Memory.ChildWidgets[Type] += WidgetSize;
+				if (!ToggleWidget->IsSlotShown(ToggleSlot))
+				{
+					Memory.InactiveChildWidgets += WidgetSize;
+				}
+			}
+		}
+
+		return Memory;
+	}
+
+	static FString MakeRow(const FToggleMemory& Memory, const TCHAR* Separator)
+	{
+		FString Row = FString::Printf(TEXT("%d%s%llu"), Memory.NumSlots, Separator, (uint64)Memory.SlotStorage);
+		for (SIZE_T Size : Memory.ChildWidgets)
+		{
+			Row += FString::Printf(TEXT("%s%llu"), Separator, (uint64)Size);
+		}
+		Row += FString::Printf(TEXT("%s%llu%s%llu%s%llu"), Separator, (uint64)Memory.InactiveChildWidgets,
+			Separator, (uint64)Memory.SlotObjects, Separator, (uint64)Memory.GetTotal());
+		return Row;
+	}
+
+	static FString MakeHeader(const TCHAR* Separator)
+	{
+		FString Header = FString::Printf(TEXT("Slots%sSlotStorage"), Separator);
+		const UEnum* SlotTypeEnum = StaticEnum<EToggleSlotType>();
+		for (int32 Type = 0; Type < NumSlotTypes; ++Type)
+		{
+			Header += FString::Printf(TEXT("%s%sWidgets"), Separator, *SlotTypeEnum->GetNameStringByValue(Type));
+		}
+		Header += FString::Printf(TEXT("%sInactiveWidgets%sSlotObjects%sTotal"), Separator, Separator, Separator);
+		return Header;
+	}
+
+	/**
+	 * Reports the memory of every live toggle, estimated from type and UObject class sizes.
+	 * Widget columns are lower bounds, the concrete widget types are not known here.
+	 * Usage: UMGExt.Toggle.MemReport [-csv[=Path]]
+	 */
+	static void Report(const TArray<FString>& Args, UWorld* World, FOutputDevice& Ar)
+	{
+		TArray<FToggleMemory> Toggles;
+		FToggleMemory Total;
+		Total.Name = TEXT("Total");
+
+		for (TObjectIterator<UMyToggle> It; It; ++It)
+		{
+			if (!It->IsTemplate())
+			{
+				Toggles.Add(MeasureToggle(*It));
+				Total.Accumulate(Toggles.Last());
+			}
+		}
+
+		Toggles.Sort([](const FToggleMemory& A, const FToggleMemory& B) { return A.GetTotal() > B.GetTotal(); });
+
+		Ar.Logf(TEXT("%d toggle(s), bytes (widget columns are lower bounds): %s"), Toggles.Num(), *MakeHeader(TEXT(" ")));
+		for (const FToggleMemory& Memory : Toggles)
+		{
+			Ar.Logf(TEXT("  %s %s"), *MakeRow(Memory, TEXT(" ")), *Memory.Name);
+		}
+		Ar.Logf(TEXT("  %s Total"), *MakeRow(Total, TEXT(" ")));
+
+		for (const FString& Arg : Args)
+		{
+			if (Arg.StartsWith(TEXT("-csv")))
+			{
+				FString Path;
+				if (!FParse::Value(*Arg, TEXT("-csv="), Path))
+				{
+					Path = FPaths::ProfilingDir() / FString::Printf(TEXT("ToggleMemory-%s.csv"), *FDateTime::Now().ToString());
+				}
+
+				FString Csv = TEXT("Toggle,") + MakeHeader(TEXT(",")) + LINE_TERMINATOR;
+				for (const FToggleMemory& Memory : Toggles)
+				{
+					Csv += FString::Printf(TEXT("%s,%s%s"), *Memory.Name, *MakeRow(Memory, TEXT(",")), LINE_TERMINATOR);
+				}
+				Csv += FString::Printf(TEXT("Total,%s%s"), *MakeRow(Total, TEXT(",")), LINE_TERMINATOR);
+
+				if (FFileHelper::SaveStringToFile(Csv, *Path))
+				{
+					Ar.Logf(TEXT("Wrote %s"), *Path);
+				}
+				else
+				{
+					Ar.Logf(TEXT("Failed to write %s"), *Path);
+				}
+			}
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldArgsAndOutputDevice ReportCommand(
+		TEXT("UMGExt.Toggle.MemReport"),
+		TEXT("Reports the memory of every live toggle: slots, child widgets by slot type, widgets of inactive states and slot UObjects. Widget sizes are lower bounds. Args: [-csv[=Path]]"),
+		FConsoleCommandWithWorldArgsAndOutputDeviceDelegate::CreateStatic(&Report));
+}
@@ -0,0 +1,155 @@
+#include "MyToggleMenuCache.h"
+#include "HAL/IConsoleManager.h"
+#include "HAL/PlatformTime.h"
+#include "Misc/CoreDelegates.h"
+#include "Widgets/SNullWidget.h"
+#include "Framework/Application/SlateApplication.h"
+
+static int32 GMyToggleMenuCacheSize = 8;
+static FAutoConsoleVariableRef CVarMyToggleMenuCacheSize(
+	TEXT("UMGExt.Toggle.MenuCacheSize"),
+	GMyToggleMenuCacheSize,
+	TEXT("Number of toggle context menus kept built, the least recently used one is dropped beyond it. 0 disables the cache."));
+
+static float GMyToggleMenuPrebuildBudgetMs = 1.0f;
+static FAutoConsoleVariableRef CVarMyToggleMenuPrebuildBudgetMs(
+	TEXT("UMGExt.Toggle.MenuPrebuildBudgetMs"),
+	GMyToggleMenuPrebuildBudgetMs,
+	TEXT("Time in milliseconds spent per frame prebuilding toggle context menus, at least one menu is built per frame."));
+
+FMyToggleMenuCache& FMyToggleMenuCache::Get()
+{
+	static FMyToggleMenuCache MenuCache;
+	return MenuCache;
+}
+
+FMyToggleMenuCache::FMyToggleMenuCache()
+{
+	// The cached menus are Slate widgets, they must not outlive the Slate application.
+	PreExitHandle = FCoreDelegates::OnPreExit.AddRaw(this, &FMyToggleMenuCache::Shutdown);
+}
+
+FMyToggleMenuCache::FEntry* FMyToggleMenuCache::Find(FName Key)
+{
+	return Entries.FindByPredicate([Key](const FEntry& Entry) { return Entry.Key == Key; });
+}
+
+TSharedRef<SWidget> FMyToggleMenuCache::GetOrBuild(FName Key, const FOnGetContent& Builder)
+{
+	check(IsInGameThread());
+
+	if (FEntry* Entry = Find(Key))
+	{
+		Entry->LastUseFrame = GFrameCounter;
+		return Entry->Content.ToSharedRef();
+	}
+
+	TSharedRef<SWidget> Content = Builder.IsBound() ? Builder.Execute() : SNullWidget::NullWidget;
+	if (Key != NAME_None && Content != SNullWidget::NullWidget)
+	{
+		Add(Key, Content);
+	}
+	return Content;
+}
+
+void FMyToggleMenuCache::Add(FName Key, const TSharedRef<SWidget>& Content)
+{
+	if (GMyToggleMenuCacheSize <= 0)
+	{
+		return;
+	}
+
+	// Few menus are cached, a linear scan for the oldest beats keeping an ordered list up to date.
+	while (Entries.Num() >= GMyToggleMenuCacheSize)
+	{
+		int32 OldestIndex = 0;
+		for (int32 EntryIndex = 1; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			if (Entries[EntryIndex].LastUseFrame < Entries[OldestIndex].LastUseFrame)
+			{
+				OldestIndex = EntryIndex;
+			}
+		}
+		Entries.RemoveAtSwap(OldestIndex);
+	}
+
+	FEntry Entry;
+	Entry.Key = Key;
+	Entry.Content = Content;
+	Entry.LastUseFrame = GFrameCounter;
+	Entries.Add(Entry);
+}
+
+void FMyToggleMenuCache::RequestPrebuild(FName Key, const FOnGetContent& Builder)
+{
+	check(IsInGameThread());
+
+	if (Key == NAME_None || GMyToggleMenuCacheSize <= 0 || Find(Key) != nullptr)
+	{
+		return;
+	}
+
+	if (Prebuilds.ContainsByPredicate([Key](const FPrebuild& Prebuild) { return Prebuild.Key == Key; }))
+	{
+		return;
+	}
+
+	if (!PreTickHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		PreTickHandle = FSlateApplication::Get().OnPreTick().AddRaw(this, &FMyToggleMenuCache::OnSlatePreTick);
+	}
+
+	FPrebuild Prebuild;
+	Prebuild.Key = Key;
+	Prebuild.Builder = Builder;
+	Prebuilds.Add(Prebuild);
+}
+
+void FMyToggleMenuCache::Invalidate(FName Key)
+{
+	Entries.RemoveAllSwap([Key](const FEntry& Entry) { return Entry.Key == Key; });
+	Prebuilds.RemoveAll([Key](const FPrebuild& Prebuild) { return Prebuild.Key == Key; });
+}
+
+void FMyToggleMenuCache::InvalidateAll()
+{
+	Entries.Reset();
+	Prebuilds.Reset();
+}
+
+void FMyToggleMenuCache::Shutdown()
+{
+	Entries.Empty();
+	Prebuilds.Empty();
+
+	if (PreTickHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnPreTick().Remove(PreTickHandle);
+	}
+	PreTickHandle.Reset();
+
+	FCoreDelegates::OnPreExit.Remove(PreExitHandle);
+	PreExitHandle.Reset();
+}
+
+void FMyToggleMenuCache::OnSlatePreTick(float DeltaTime)
+{
+	if (Prebuilds.Num() == 0)
+	{
+		return;
+	}
+
+	const double EndTime = FPlatformTime::Seconds() + GMyToggleMenuPrebuildBudgetMs / 1000.0;
+
+	// Latest hovered first, it is the one most likely to be opened next.
+	int32 NumBuilt = 0;
+	while (Prebuilds.Num() > 0 && (NumBuilt == 0 || FPlatformTime::Seconds() < EndTime))
+	{
+		const FPrebuild Prebuild = Prebuilds.Pop(false);
+		if (Find(Prebuild.Key) == nullptr)
+		{
+			GetOrBuild(Prebuild.Key, Prebuild.Builder);
+			++NumBuilt;
+		}
+	}
+}
@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Framework/SlateDelegates.h"
+
+class SWidget;
+
+/**
+ * Keeps the context menu content built by SMyToggle::OnGetMenuContent, keyed by the toggle's MenuContentKey,
+ * so toggles sharing a menu build it once. Holds at most UMGExt.Toggle.MenuCacheSize menus and evicts the
+ * least recently used one. Menus can be prebuilt ahead of the right click, prebuilds run in the Slate pre tick
+ * under UMGExt.Toggle.MenuPrebuildBudgetMs.
+ * A cached menu keeps its widget state (scroll offsets, expanded entries) between openings.
+ */
+class UMGEXTENTIONSAMPLE_API FMyToggleMenuCache
+{
+public:
+	static FMyToggleMenuCache& Get();
+
+	/** The cached content of Key, built with Builder if there is none. */
+	TSharedRef<SWidget> GetOrBuild(FName Key, const FOnGetContent& Builder);
+
+	/** Queues Key to be built in a coming Slate pre tick unless it is cached already. */
+	void RequestPrebuild(FName Key, const FOnGetContent& Builder);
+
+	/** Drops the content of Key, it is rebuilt on next use. E.g. when the menu's entries changed. */
+	void Invalidate(FName Key);
+
+	void InvalidateAll();
+
+	/** Drops the menus and prebuilds and unhooks from Slate. Runs on FCoreDelegates::OnPreExit, before Slate shuts down. */
+	void Shutdown();
+
+	int32 Num() const
+	{
+		return Entries.Num();
+	}
+
+private:
+	struct FEntry
+	{
+		FName Key;
+		TSharedPtr<SWidget> Content;
+		uint64 LastUseFrame;
+	};
+
+	struct FPrebuild
+	{
+		FName Key;
+		FOnGetContent Builder;
+	};
+
+	FMyToggleMenuCache();
+
+	FEntry* Find(FName Key);
+	void Add(FName Key, const TSharedRef<SWidget>& Content);
+	void OnSlatePreTick(float DeltaTime);
+
+	TArray<FEntry> Entries;
+	TArray<FPrebuild> Prebuilds;
+
+	FDelegateHandle PreTickHandle;
+	FDelegateHandle PreExitHandle;
+};
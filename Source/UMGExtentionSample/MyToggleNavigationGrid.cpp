@@ -0,0 +1,239 @@
+#include "MyToggleNavigationGrid.h"
+#include "SMyToggle.h"
+#include "Layout/Geometry.h"
+#include "Algo/Sort.h"
+#include "Algo/BinarySearch.h"
+
+FMyToggleNavigationGrid::FMyToggleNavigationGrid()
+	: bWrap(false)
+	, bSkipDisabled(true)
+	, bDirty(false)
+{
+}
+
+void FMyToggleNavigationGrid::SetWrap(bool bInWrap)
+{
+	bDirty |= bWrap != bInWrap;
+	bWrap = bInWrap;
+}
+
+void FMyToggleNavigationGrid::SetSkipDisabled(bool bInSkipDisabled)
+{
+	bSkipDisabled = bInSkipDisabled;
+}
+
+void FMyToggleNavigationGrid::AddToggle(SMyToggle& Toggle)
+{
+	if (MemberIndices.Contains(&Toggle))
+	{
+		return;
+	}
+
+	FMember Member;
+	Member.Toggle = StaticCastSharedRef<SMyToggle>(Toggle.AsShared());
+	Member.bHasGeometry = false;
+	for (int32& Neighbour : Member.Neighbours)
+	{
+		Neighbour = INDEX_NONE;
+	}
+
+	MemberIndices.Add(&Toggle, Members.Add(Member));
+	bDirty = true;
+}
+
+void FMyToggleNavigationGrid::RemoveToggle(const SMyToggle& Toggle)
+{
+	int32 MemberIndex = INDEX_NONE;
+	if (!MemberIndices.RemoveAndCopyValue(&Toggle, MemberIndex))
+	{
+		return;
+	}
+
+	Members.RemoveAtSwap(MemberIndex);
+	if (Members.IsValidIndex(MemberIndex))
+	{
+		// The last member moved into the gap. Its toggle may already be destroyed, in which case
+		// it is about to remove itself and no longer has an entry to fix.
+		for (TPair<const SMyToggle*, int32>& Pair : MemberIndices)
+		{
+			if (Pair.Value == Members.Num())
+			{
+				Pair.Value = MemberIndex;
+				break;
+			}
+		}
+	}
+
+	bDirty = true;
+}
+
+void FMyToggleNavigationGrid::UpdateGeometry(const SMyToggle& Toggle, const FGeometry& Geometry)
+{
+	const int32* MemberIndex = MemberIndices.Find(&Toggle);
+	if (MemberIndex == nullptr)
+	{
+		return;
+	}
+
+	FMember& Member = Members[*MemberIndex];
+	const FSlateRect Rect = FSlateRect::FromPointAndExtent(Geometry.GetAbsolutePosition(), Geometry.GetAbsoluteSize());
+	if (!Member.bHasGeometry || !(Member.Rect == Rect))
+	{
+		Member.Rect = Rect;
+		Member.bHasGeometry = true;
+		bDirty = true;
+	}
+}
+
+void FMyToggleNavigationGrid::Rebuild()
+{
+	bDirty = false;
+
+	struct FCell
+	{
+		int32 MemberIndex;
+		FVector2D Center;
+	};
+
+	TArray<FCell> Cells;
+	Cells.Reserve(Members.Num());
+	float TotalHeight = 0.0f;
+	for (int32 MemberIndex = 0; MemberIndex < Members.Num(); ++MemberIndex)
+	{
+		FMember& Member = Members[MemberIndex];
+		for (int32& Neighbour : Member.Neighbours)
+		{
+			Neighbour = INDEX_NONE;
+		}
+
+		if (Member.bHasGeometry)
+		{
+			Cells.Add({ MemberIndex, Member.Rect.GetCenter() });
+			TotalHeight += Member.Rect.GetSize().Y;
+		}
+	}
+
+	if (Cells.Num() == 0)
+	{
+		return;
+	}
+
+	// Toggles whose centers are less than half a toggle apart vertically share a row.
+	const float RowTolerance = 0.5f * TotalHeight / Cells.Num();
+	Cells.Sort([](const FCell& A, const FCell& B) { return A.Center.Y < B.Center.Y; });
+
+	TArray<int32> RowStarts;
+	float RowTop = -FLT_MAX;
+	for (int32 CellIndex = 0; CellIndex < Cells.Num(); ++CellIndex)
+	{
+		if (Cells[CellIndex].Center.Y > RowTop + RowTolerance)
+		{
+			RowStarts.Add(CellIndex);
+			RowTop = Cells[CellIndex].Center.Y;
+		}
+	}
+	RowStarts.Add(Cells.Num());
+
+	const int32 NumRows = RowStarts.Num() - 1;
+	for (int32 Row = 0; Row < NumRows; ++Row)
+	{
+		TArrayView<FCell> RowCells(Cells.GetData() + RowStarts[Row], RowStarts[Row + 1] - RowStarts[Row]);
+		Algo::SortBy(RowCells, [](const FCell& Cell) { return Cell.Center.X; });
+	}
+
+	for (int32 Row = 0; Row < NumRows; ++Row)
+	{
+		const int32 RowStart = RowStarts[Row];
+		const int32 RowNum = RowStarts[Row + 1] - RowStart;
+
+		int32 RowAbove = Row - 1;
+		int32 RowBelow = Row + 1;
+		if (bWrap)
+		{
+			RowAbove = (RowAbove + NumRows) % NumRows;
+			RowBelow = RowBelow % NumRows;
+		}
+
+		for (int32 Column = 0; Column < RowNum; ++Column)
+		{
+			const FCell& Cell = Cells[RowStart + Column];
+			int32* Neighbours = Members[Cell.MemberIndex].Neighbours;
+
+			int32 Left = Column - 1;
+			int32 Right = Column + 1;
+			if (bWrap)
+			{
+				Left = (Left + RowNum) % RowNum;
+				Right = Right % RowNum;
+			}
+			if (Left >= 0 && Left != Column)
+			{
+				Neighbours[(int32)EUINavigation::Left] = Cells[RowStart + Left].MemberIndex;
+			}
+			if (Right < RowNum && Right != Column)
+			{
+				Neighbours[(int32)EUINavigation::Right] = Cells[RowStart + Right].MemberIndex;
+			}
+
+			// Up and down go to the toggle of the next row closest horizontally.
+			auto FindClosestInRow = [&Cells, &RowStarts, &Cell](int32 OtherRow)
+			{
+				TArrayView<const FCell> OtherCells(Cells.GetData() + RowStarts[OtherRow], RowStarts[OtherRow + 1] - RowStarts[OtherRow]);
+				int32 Closest = Algo::LowerBoundBy(OtherCells, Cell.Center.X, [](const FCell& Other) { return Other.Center.X; });
+				if (Closest == OtherCells.Num()
+					|| (Closest > 0 && Cell.Center.X - OtherCells[Closest - 1].Center.X < OtherCells[Closest].Center.X - Cell.Center.X))
+				{
+					--Closest;
+				}
+				return OtherCells[Closest].MemberIndex;
+			};
+
+			if (RowAbove >= 0 && RowAbove != Row)
+			{
+				Neighbours[(int32)EUINavigation::Up] = FindClosestInRow(RowAbove);
+			}
+			if (RowBelow < NumRows && RowBelow != Row)
+			{
+				Neighbours[(int32)EUINavigation::Down] = FindClosestInRow(RowBelow);
+			}
+		}
+	}
+}
+
+bool FMyToggleNavigationGrid::IsNavigable(int32 MemberIndex) const
+{
+	TSharedPtr<SMyToggle> Toggle = Members[MemberIndex].Toggle.Pin();
+	return Toggle.IsValid() && Toggle->IsEnabled() && Toggle->GetVisibility().IsVisible() && Toggle->SupportsKeyboardFocus();
+}
+
+TSharedPtr<SWidget> FMyToggleNavigationGrid::FindNeighbour(const SMyToggle& Toggle, EUINavigation Direction)
+{
+	const int32 DirectionIndex = (int32)Direction;
+	const int32* MemberIndex = MemberIndices.Find(&Toggle);
+	if (MemberIndex == nullptr || DirectionIndex < 0 || DirectionIndex >= NumDirections)
+	{
+		return nullptr;
+	}
+
+	if (bDirty)
+	{
+		Rebuild();
+	}
+
+	int32 Neighbour = Members[*MemberIndex].Neighbours[DirectionIndex];
+	if (bSkipDisabled)
+	{
+		// Follows the same direction past toggles that can't take focus, at most once around the grid.
+		for (int32 Step = 0; Neighbour != INDEX_NONE && Neighbour != *MemberIndex && !IsNavigable(Neighbour); ++Step)
+		{
+			Neighbour = Step < Members.Num() ? Members[Neighbour].Neighbours[DirectionIndex] : INDEX_NONE;
+		}
+	}
+
+	if (Neighbour == INDEX_NONE || Neighbour == *MemberIndex)
+	{
+		return nullptr;
+	}
+
+	return Members[Neighbour].Toggle.Pin();
+}
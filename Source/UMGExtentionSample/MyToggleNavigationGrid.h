@@ -0,0 +1,68 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+#include "Types/SlateEnums.h"
+
+class SWidget;
+class SMyToggle;
+struct FGeometry;
+
+/**
+ * Explicit navigation between the toggles of a group. Toggles are sorted into rows by their painted
+ * geometry and their left/right/up/down neighbours are stored, so a d-pad press is a lookup instead of
+ * Slate's search through the widget tree. The neighbours are rebuilt on the first navigation after
+ * a toggle of the group was added, removed or painted somewhere else.
+ * Next and Previous are left to Slate.
+ */
+class UMGEXTENTIONSAMPLE_API FMyToggleNavigationGrid
+{
+public:
+	FMyToggleNavigationGrid();
+
+	/** Navigating off an edge continues on the other side of the same row or column. */
+	void SetWrap(bool bInWrap);
+
+	/** Disabled and hidden toggles are passed over. */
+	void SetSkipDisabled(bool bInSkipDisabled);
+
+	/** Called by SMyToggle::SetNavigationGrid. */
+	void AddToggle(SMyToggle& Toggle);
+	void RemoveToggle(const SMyToggle& Toggle);
+
+	/** Called when the toggle is painted, marks the neighbours dirty if it moved. */
+	void UpdateGeometry(const SMyToggle& Toggle, const FGeometry& Geometry);
+
+	/** The toggle to focus when navigating from Toggle, null when the grid has none in that direction. */
+	TSharedPtr<SWidget> FindNeighbour(const SMyToggle& Toggle, EUINavigation Direction);
+
+	int32 Num() const
+	{
+		return Members.Num();
+	}
+
+private:
+	enum { NumDirections = 4 };
+
+	struct FMember
+	{
+		TWeakPtr<SMyToggle> Toggle;
+		/** Absolute rect of the last paint */
+		FSlateRect Rect;
+		bool bHasGeometry;
+		/** Indexed by EUINavigation Left, Right, Up, Down */
+		int32 Neighbours[NumDirections];
+	};
+
+	void Rebuild();
+	bool IsNavigable(int32 MemberIndex) const;
+
+	TArray<FMember> Members;
+	TMap<const SMyToggle*, int32> MemberIndices;
+
+	bool bWrap;
+	bool bSkipDisabled;
+	bool bDirty;
+};
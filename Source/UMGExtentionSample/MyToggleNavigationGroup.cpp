@@ -0,0 +1,53 @@
+#include "MyToggleNavigationGroup.h"
+#include "MyToggleNavigationGrid.h"
+
+/////////////////////////////////////////////////////
+// UMyToggleNavigationGroup
+
+UMyToggleNavigationGroup::UMyToggleNavigationGroup(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+	, bWrap(false)
+	, bSkipDisabled(true)
+{
+}
+
+void UMyToggleNavigationGroup::SetWrap(bool bInWrap)
+{
+	bWrap = bInWrap;
+	if (Grid.IsValid())
+	{
+		Grid->SetWrap(bWrap);
+	}
+}
+
+void UMyToggleNavigationGroup::SetSkipDisabled(bool bInSkipDisabled)
+{
+	bSkipDisabled = bInSkipDisabled;
+	if (Grid.IsValid())
+	{
+		Grid->SetSkipDisabled(bSkipDisabled);
+	}
+}
+
+TSharedRef<FMyToggleNavigationGrid> UMyToggleNavigationGroup::GetGrid()
+{
+	if (!Grid.IsValid())
+	{
+		Grid = MakeShared<FMyToggleNavigationGrid>();
+		Grid->SetWrap(bWrap);
+		Grid->SetSkipDisabled(bSkipDisabled);
+	}
+	return Grid.ToSharedRef();
+}
+
+#if WITH_EDITOR
+
+void UMyToggleNavigationGroup::PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent)
+{
+	Super::PostEditChangeProperty(PropertyChangedEvent);
+
+	SetWrap(bWrap);
+	SetSkipDisabled(bSkipDisabled);
+}
+
+#endif
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/Object.h"
+#include "MyToggleNavigationGroup.generated.h"
+
+class FMyToggleNavigationGrid;
+
+/**
+ * Toggles navigated with the d-pad or arrow keys as one grid, see FMyToggleNavigationGrid.
+ * Toggles join with UMyToggle::SetNavigationGroup.
+ */
+UCLASS(BlueprintType)
+class UMGEXTENTIONSAMPLE_API UMyToggleNavigationGroup : public UObject
+{
+	GENERATED_UCLASS_BODY()
+public:
+	/** Navigating off an edge continues on the other side of the same row or column */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Navigation")
+	bool bWrap;
+
+	/** Disabled and hidden toggles are passed over */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Navigation")
+	bool bSkipDisabled;
+
+public:
+	UFUNCTION(BlueprintCallable, Category = "Navigation")
+	void SetWrap(bool bInWrap);
+
+	UFUNCTION(BlueprintCallable, Category = "Navigation")
+	void SetSkipDisabled(bool bInSkipDisabled);
+
+	/** The grid shared by the Slate widgets of the group's toggles. */
+	TSharedRef<FMyToggleNavigationGrid> GetGrid();
+
+#if WITH_EDITOR
+	virtual void PostEditChangeProperty(FPropertyChangedEvent& PropertyChangedEvent) override;
+#endif
+
+private:
+	TSharedPtr<FMyToggleNavigationGrid> Grid;
+};
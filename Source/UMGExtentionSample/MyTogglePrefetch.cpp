@@ -0,0 +1,76 @@
+#include "MyTogglePrefetch.h"
+#include "HAL/IConsoleManager.h"
+#include "Styling/SlateBrush.h"
+#include "Engine/Texture2D.h"
+#include "Materials/MaterialInterface.h"
+#include "Components/Widget.h"
+#include "Blueprint/WidgetTree.h"
+#include "UObject/UnrealType.h"
+
+static float GMyTogglePrefetchResidentSeconds = 5.0f;
+static FAutoConsoleVariableRef CVarMyTogglePrefetchResidentSeconds(
+	TEXT("UMGExt.Toggle.PrefetchResidentSeconds"),
+	GMyTogglePrefetchResidentSeconds,
+	TEXT("Seconds the textures of a toggle state prefetched on hover or focus are kept fully resident."));
+
+namespace MyTogglePrefetch
+{
+	/** Styles nest brushes a couple of levels deep (FCheckBoxStyle -> FSlateBrush), deeper structs aren't looked into. */
+	static const int32 MaxStructDepth = 3;
+
+	static void RequestStructResources(const UStruct* Struct, const void* Container, float ResidentSeconds, int32 Depth)
+	{
+		for (TFieldIterator<UStructProperty> It(Struct); It; ++It)
+		{
+			const UStructProperty* Property = *It;
+			for (int32 Index = 0; Index < Property->ArrayDim; ++Index)
+			{
+				const void* Value = Property->ContainerPtrToValuePtr<void>(Container, Index);
+				if (Property->Struct->IsChildOf(FSlateBrush::StaticStruct()))
+				{
+					RequestBrushResources(*static_cast<const FSlateBrush*>(Value), ResidentSeconds);
+				}
+				else if (Depth < MaxStructDepth)
+				{
+					RequestStructResources(Property->Struct, Value, ResidentSeconds, Depth + 1);
+				}
+			}
+		}
+	}
+
+	float GetResidentSeconds()
+	{
+		return GMyTogglePrefetchResidentSeconds;
+	}
+
+	void RequestBrushResources(const FSlateBrush& Brush, float ResidentSeconds)
+	{
+		UObject* Resource = Brush.GetResourceObject();
+		if (UTexture2D* Texture = Cast<UTexture2D>(Resource))
+		{
+			Texture->SetForceMipLevelsToBeResident(ResidentSeconds);
+		}
+		else if (UMaterialInterface* Material = Cast<UMaterialInterface>(Resource))
+		{
+			Material->SetForceMipLevelsToBeResident(false, false, ResidentSeconds);
+		}
+	}
+
+	void RequestStructResources(const UStruct* Struct, const void* Container, float ResidentSeconds)
+	{
+		RequestStructResources(Struct, Container, ResidentSeconds, 0);
+	}
+
+	void RequestWidgetResources(UWidget* Widget, float ResidentSeconds)
+	{
+		if (Widget == nullptr)
+		{
+			return;
+		}
+
+		UWidgetTree::ForWidgetAndChildren(Widget, [ResidentSeconds](UWidget* Child)
+		{
+			RequestStructResources(Child->GetClass(), Child, ResidentSeconds, 0);
+		});
+	}
+}
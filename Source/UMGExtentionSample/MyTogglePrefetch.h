@@ -0,0 +1,27 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWidget;
+class UStruct;
+struct FSlateBrush;
+
+/**
+ * Requests the resources a toggle state needs before it is shown. Textures are handed to the texture
+ * streamer, which loads their mips asynchronously and keeps them resident for the given time.
+ */
+namespace MyTogglePrefetch
+{
+	/** Seconds prefetched textures are kept resident, see UMGExt.Toggle.PrefetchResidentSeconds. */
+	UMGEXTENTIONSAMPLE_API float GetResidentSeconds();
+
+	UMGEXTENTIONSAMPLE_API void RequestBrushResources(const FSlateBrush& Brush, float ResidentSeconds);
+
+	/** Requests the brushes of every FSlateBrush property of the struct, including those of nested styles. */
+	UMGEXTENTIONSAMPLE_API void RequestStructResources(const UStruct* Struct, const void* Container, float ResidentSeconds);
+
+	/** Requests the brushes of the widget and all its children. */
+	UMGEXTENTIONSAMPLE_API void RequestWidgetResources(UWidget* Widget, float ResidentSeconds);
+}
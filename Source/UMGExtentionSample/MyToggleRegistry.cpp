@@ -0,0 +1,50 @@
+#include "MyToggleRegistry.h"
+#include "MyToggle.h"
+
+FMyToggleRegistry& FMyToggleRegistry::Get()
+{
+	static FMyToggleRegistry Registry;
+	return Registry;
+}
+
+FMyToggleRegistry::FMyToggleRegistry()
+	: NextSerial(1)
+{
+}
+
+FMyToggleHandle FMyToggleRegistry::Register(UMyToggle* Toggle)
+{
+	check(IsInGameThread());
+
+	const int32 Index = FreeIndices.Num() > 0 ? FreeIndices.Pop(false) : Entries.AddDefaulted();
+
+	FEntry& Entry = Entries[Index];
+	Entry.Toggle = Toggle;
+	Entry.Serial = NextSerial++;
+
+	return FMyToggleHandle(Index, Entry.Serial);
+}
+
+void FMyToggleRegistry::Unregister(const FMyToggleHandle& Handle)
+{
+	check(IsInGameThread());
+
+	if (Entries.IsValidIndex(Handle.Index) && Entries[Handle.Index].Serial == Handle.Serial)
+	{
+		Entries[Handle.Index].Toggle.Reset();
+		Entries[Handle.Index].Serial = 0;
+		FreeIndices.Add(Handle.Index);
+	}
+}
+
+UMyToggle* FMyToggleRegistry::Find(const FMyToggleHandle& Handle) const
+{
+	check(IsInGameThread());
+
+	if (Entries.IsValidIndex(Handle.Index) && Entries[Handle.Index].Serial == Handle.Serial)
+	{
+		return Entries[Handle.Index].Toggle.Get();
+	}
+
+	return nullptr;
+}
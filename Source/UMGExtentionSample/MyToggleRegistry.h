@@ -0,0 +1,77 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/WeakObjectPtr.h"
+
+class UMyToggle;
+
+/**
+ * Plain identifier of a toggle that can be copied to and used from any thread.
+ * The serial tells a released toggle apart from a newer one that reuses its index.
+ */
+struct FMyToggleHandle
+{
+	int32 Index;
+	int32 Serial;
+
+	FMyToggleHandle()
+		: Index(INDEX_NONE)
+		, Serial(0)
+	{
+	}
+
+	FMyToggleHandle(int32 InIndex, int32 InSerial)
+		: Index(InIndex)
+		, Serial(InSerial)
+	{
+	}
+
+	bool IsValid() const
+	{
+		return Index != INDEX_NONE;
+	}
+
+	bool operator==(const FMyToggleHandle& Other) const
+	{
+		return Index == Other.Index && Serial == Other.Serial;
+	}
+
+	bool operator!=(const FMyToggleHandle& Other) const
+	{
+		return !(*this == Other);
+	}
+};
+
+/** Game thread table from toggle handles to toggles, see UMyToggle::GetToggleHandle. */
+class UMGEXTENTIONSAMPLE_API FMyToggleRegistry
+{
+public:
+	static FMyToggleRegistry& Get();
+
+	FMyToggleHandle Register(UMyToggle* Toggle);
+	void Unregister(const FMyToggleHandle& Handle);
+
+	/** The toggle of a handle, null once it was unregistered. */
+	UMyToggle* Find(const FMyToggleHandle& Handle) const;
+
+	/** Number of handle indices in use or free, handle indices are below it. */
+	int32 GetMaxIndex() const
+	{
+		return Entries.Num();
+	}
+
+private:
+	struct FEntry
+	{
+		TWeakObjectPtr<UMyToggle> Toggle;
+		int32 Serial;
+	};
+
+	FMyToggleRegistry();
+
+	TArray<FEntry> Entries;
+	TArray<int32> FreeIndices;
+	int32 NextSerial;
+};
@@ -1,6 +1,7 @@
 #include "MyToggleSlot.h"
 #include "SMyToggle.h"
 #include "MyToggle.h"
+#include "Widgets/Layout/SSpacer.h"
 
 /////////////////////////////////////////////////////
 // UMyToggleSlot
@@ -8,6 +9,8 @@
 UMyToggleSlot::UMyToggleSlot(const FObjectInitializer& ObjectInitializer)
 	: Super(ObjectInitializer)
 	, Slot(nullptr)
+	, bPendingContent(false)
+	, bSlotSynced(false)
 {
 	LayoutData.Offsets = FMargin(0, 0, 100, 30);
 	LayoutData.Anchors = FAnchors(0.0f, 0.0f);
@@ -15,6 +18,8 @@ UMyToggleSlot::UMyToggleSlot(const FObjectInitializer& ObjectInitializer)
 	bAutoSize = false;
 	ZOrder = 0;
 	SlotType = EToggleSlotType::Other;
+	StateMask = (int32)EToggleStateFlags::All;
+	MinimumDrawSize = 0.0f;
 }
 
 void UMyToggleSlot::ReleaseSlateResources(bool bReleaseChildren)
@@ -22,18 +27,58 @@ void UMyToggleSlot::ReleaseSlateResources(bool bReleaseChildren)
 	Super::ReleaseSlateResources(bReleaseChildren);
 
 	Slot = nullptr;
+	OwningToggle.Reset();
+	bPendingContent = false;
+	bSlotSynced = false;
 }
 
-void UMyToggleSlot::BuildSlot(TSharedRef<SMyToggle> Toggle)
+void UMyToggleSlot::BuildSlot(TSharedRef<SMyToggle> Toggle, bool bDeferContent)
 {
+	OwningToggle = Toggle;
+	bPendingContent = bDeferContent && Content != nullptr;
+	bSlotSynced = false;
+
+	TSharedRef<SWidget> SlotContent = SNullWidget::NullWidget;
+	if (bPendingContent)
+	{
+		// Fixed size slots keep their layout on their own, size-to-content ones get a stand-in of the slot's size.
+		if (bAutoSize)
+		{
+			SlotContent = SNew(SSpacer).Size(FVector2D(LayoutData.Offsets.Right, LayoutData.Offsets.Bottom));
+		}
+	}
+	else if (Content != nullptr)
+	{
+		SlotContent = Content->TakeWidget();
+	}
+
 	Slot = &Toggle->AddSlot()
 		[
-			Content == nullptr ? SNullWidget::NullWidget : Content->TakeWidget()
+			SlotContent
 		];
 
 	SynchronizeProperties();
 }
 
+void UMyToggleSlot::BuildPendingContent()
+{
+	if (!bPendingContent || Slot == nullptr)
+	{
+		return;
+	}
+
+	bPendingContent = false;
+	if (Content != nullptr)
+	{
+		Slot->AttachWidget(Content->TakeWidget());
+
+		if (TSharedPtr<SMyToggle> Toggle = OwningToggle.Pin())
+		{
+			Toggle->Invalidate(EInvalidateWidget::Layout);
+		}
+	}
+}
+
 #if WITH_EDITOR
 
 bool UMyToggleSlot::NudgeByDesigner(const FVector2D& NudgeDirection, const TOptional<int32>& GridSnapSize)
@@ -127,9 +172,9 @@ void UMyToggleSlot::SetLayout(const FAnchorData& InLayoutData)
 
 	if (Slot)
 	{
-		Slot->Offset(LayoutData.Offsets);
-		Slot->Anchors(LayoutData.Anchors);
-		Slot->Alignment(LayoutData.Alignment);
+		PushOffsets(LayoutData.Offsets);
+		PushAnchors(LayoutData.Anchors);
+		PushAlignment(LayoutData.Alignment);
 	}
 }
 
@@ -145,7 +190,7 @@ void UMyToggleSlot::SetPosition(FVector2D InPosition)
 
 	if (Slot)
 	{
-		Slot->Offset(LayoutData.Offsets);
+		PushOffsets(LayoutData.Offsets);
 	}
 }
 
@@ -167,7 +212,7 @@ void UMyToggleSlot::SetSize(FVector2D InSize)
 
 	if (Slot)
 	{
-		Slot->Offset(LayoutData.Offsets);
+		PushOffsets(LayoutData.Offsets);
 	}
 }
 
@@ -187,7 +232,7 @@ void UMyToggleSlot::SetOffsets(FMargin InOffset)
 	LayoutData.Offsets = InOffset;
 	if (Slot)
 	{
-		Slot->Offset(InOffset);
+		PushOffsets(InOffset);
 	}
 }
 
@@ -206,7 +251,7 @@ void UMyToggleSlot::SetAnchors(FAnchors InAnchors)
 	LayoutData.Anchors = InAnchors;
 	if (Slot)
 	{
-		Slot->Anchors(InAnchors);
+		PushAnchors(InAnchors);
 	}
 }
 
@@ -225,7 +270,7 @@ void UMyToggleSlot::SetAlignment(FVector2D InAlignment)
 	LayoutData.Alignment = InAlignment;
 	if (Slot)
 	{
-		Slot->Alignment(InAlignment);
+		PushAlignment(InAlignment);
 	}
 }
 
@@ -244,7 +289,7 @@ void UMyToggleSlot::SetAutoSize(bool InbAutoSize)
 	bAutoSize = InbAutoSize;
 	if (Slot)
 	{
-		Slot->AutoSize(InbAutoSize);
+		PushAutoSize(InbAutoSize);
 	}
 }
 
@@ -263,7 +308,7 @@ void UMyToggleSlot::SetZOrder(int32 InZOrder)
 	ZOrder = InZOrder;
 	if (Slot)
 	{
-		Slot->ZOrder(InZOrder);
+		PushZOrder(InZOrder);
 	}
 }
 
@@ -282,7 +327,7 @@ void UMyToggleSlot::SetMinimum(FVector2D InMinimumAnchors)
 	LayoutData.Anchors.Minimum = InMinimumAnchors;
 	if (Slot)
 	{
-		Slot->Anchors(LayoutData.Anchors);
+		PushAnchors(LayoutData.Anchors);
 	}
 }
 
@@ -291,25 +336,169 @@ void UMyToggleSlot::SetMaximum(FVector2D InMaximumAnchors)
 	LayoutData.Anchors.Maximum = InMaximumAnchors;
 	if (Slot)
 	{
-		Slot->Anchors(LayoutData.Anchors);
+		PushAnchors(LayoutData.Anchors);
 	}
 }
 
 void UMyToggleSlot::SynchronizeProperties()
 {
-	SetOffsets(LayoutData.Offsets);
-	SetAnchors(LayoutData.Anchors);
-	SetAlignment(LayoutData.Alignment);
-	SetAutoSize(bAutoSize);
-	SetZOrder(ZOrder);
-	SetSlotType(SlotType);
+	if (Slot == nullptr)
+	{
+		return;
+	}
+
+	// Only push what changed since the last push, every push rebuilds a TAttribute on the slot
+	// and raises the matching invalidation on the toggle.
+	const bool bForce = !bSlotSynced;
+
+	if (bForce || !(Synced.Offsets == LayoutData.Offsets))
+	{
+		PushOffsets(LayoutData.Offsets);
+	}
+
+	if (bForce || Synced.Anchors.Minimum != LayoutData.Anchors.Minimum || Synced.Anchors.Maximum != LayoutData.Anchors.Maximum)
+	{
+		PushAnchors(LayoutData.Anchors);
+	}
+
+	if (bForce || Synced.Alignment != LayoutData.Alignment)
+	{
+		PushAlignment(LayoutData.Alignment);
+	}
+
+	if (bForce || Synced.bAutoSize != bAutoSize)
+	{
+		PushAutoSize(bAutoSize);
+	}
+
+	if (bForce || Synced.SlotType != SlotType)
+	{
+		PushSlotType(SlotType);
+	}
+
+	if (bForce || Synced.StateMask != StateMask)
+	{
+		PushStateMask(StateMask);
+	}
+
+	if (bForce || Synced.MinimumDrawSize != MinimumDrawSize)
+	{
+		PushMinimumDrawSize(MinimumDrawSize);
+	}
+
+	if (bForce || Synced.ZOrder != ZOrder)
+	{
+		PushZOrder(ZOrder);
+	}
+
+	bSlotSynced = true;
+}
+
+TSharedPtr<SMyToggle> UMyToggleSlot::GetToggleToInvalidate() const
+{
+	// The first push into a new slot is covered by the invalidation of AddSlot.
+	return bSlotSynced ? OwningToggle.Pin() : TSharedPtr<SMyToggle>();
+}
+
+void UMyToggleSlot::PushOffsets(const FMargin& InOffset)
+{
+	const FMargin OldOffset = Slot->OffsetAttr.Get();
+	Slot->Offset(InOffset);
+	Synced.Offsets = InOffset;
+
+	if (TSharedPtr<SMyToggle> Toggle = GetToggleToInvalidate())
+	{
+		Toggle->InvalidateSlotOffset(*Slot, OldOffset);
+	}
+}
+
+void UMyToggleSlot::PushAnchors(const FAnchors& InAnchors)
+{
+	Slot->Anchors(InAnchors);
+	Synced.Anchors = InAnchors;
+
+	// Anchors decide whether offsets are sizes or margins, so the desired size may change.
+	if (TSharedPtr<SMyToggle> Toggle = GetToggleToInvalidate())
+	{
+		Toggle->InvalidateSlotDesiredSize(*Slot);
+	}
+}
+
+void UMyToggleSlot::PushAlignment(const FVector2D& InAlignment)
+{
+	Slot->Alignment(InAlignment);
+	Synced.Alignment = InAlignment;
+
+	if (TSharedPtr<SMyToggle> Toggle = GetToggleToInvalidate())
+	{
+		Toggle->InvalidateSlotGeometry(*Slot);
+	}
+}
+
+void UMyToggleSlot::PushAutoSize(bool InbAutoSize)
+{
+	Slot->AutoSize(InbAutoSize);
+	Synced.bAutoSize = InbAutoSize;
+
+	if (TSharedPtr<SMyToggle> Toggle = GetToggleToInvalidate())
+	{
+		Toggle->InvalidateSlotDesiredSize(*Slot);
+	}
+}
+
+void UMyToggleSlot::PushZOrder(int32 InZOrder)
+{
+	Slot->ZOrder(InZOrder);
+	Synced.ZOrder = InZOrder;
+
+	// Also for the first push, the toggle caches its paint order.
+	if (TSharedPtr<SMyToggle> Toggle = OwningToggle.Pin())
+	{
+		Toggle->InvalidateSlotOrder();
+	}
+}
+
+void UMyToggleSlot::PushSlotType(EToggleSlotType InSlotType)
+{
+	const uint8 OldStateMask = Slot->GetStateMask();
+	Slot->SlotType(InSlotType);
+	Synced.SlotType = InSlotType;
+
+	if (TSharedPtr<SMyToggle> Toggle = GetToggleToInvalidate())
+	{
+		Toggle->InvalidateSlotStates(*Slot, OldStateMask);
+	}
+}
+
+void UMyToggleSlot::PushStateMask(int32 InStateMask)
+{
+	const uint8 OldStateMask = Slot->GetStateMask();
+	Slot->StateMask((uint8)InStateMask);
+	Synced.StateMask = InStateMask;
+
+	if (TSharedPtr<SMyToggle> Toggle = GetToggleToInvalidate())
+	{
+		Toggle->InvalidateSlotStates(*Slot, OldStateMask);
+	}
+}
+
+void UMyToggleSlot::PushMinimumDrawSize(float InMinimumDrawSize)
+{
+	Slot->MinDrawSize(InMinimumDrawSize);
+	Synced.MinimumDrawSize = InMinimumDrawSize;
+
+	// Only decides whether the slot is drawn, the desired size is the same either way.
+	if (TSharedPtr<SMyToggle> Toggle = GetToggleToInvalidate())
+	{
+		Toggle->InvalidateSlotGeometry(*Slot);
+	}
 }
 
 void UMyToggleSlot::SetSlotType(EToggleSlotType InSlotType)
 {
 	SlotType = InSlotType;
 	if (Slot)
-		Slot->SlotType(InSlotType);
+		PushSlotType(InSlotType);
 }
 
 EToggleSlotType UMyToggleSlot::GetSlotType() const
@@ -320,6 +509,36 @@ EToggleSlotType UMyToggleSlot::GetSlotType() const
 	return SlotType;
 }
 
+void UMyToggleSlot::SetStateMask(int32 InStateMask)
+{
+	StateMask = InStateMask;
+	if (Slot)
+		PushStateMask(InStateMask);
+}
+
+int32 UMyToggleSlot::GetStateMask() const
+{
+	if (Slot)
+		return Slot->StateMaskAttr.Get();
+
+	return StateMask;
+}
+
+void UMyToggleSlot::SetMinimumDrawSize(float InMinimumDrawSize)
+{
+	MinimumDrawSize = InMinimumDrawSize;
+	if (Slot)
+		PushMinimumDrawSize(InMinimumDrawSize);
+}
+
+float UMyToggleSlot::GetMinimumDrawSize() const
+{
+	if (Slot)
+		return Slot->MinDrawSizeAttr.Get();
+
+	return MinimumDrawSize;
+}
+
 #if WITH_EDITOR
 
 void UMyToggleSlot::PreEditChange(UProperty* PropertyThatWillChange)
@@ -41,6 +41,17 @@ public:
 
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout|Toggle Slot")
 		EToggleSlotType SlotType;
+
+	/** The check states this slot is shown in when SlotType is Masked */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout|Toggle Slot", meta = (Bitmask, BitmaskEnum = "EToggleStateFlags", EditCondition = "SlotType == EToggleSlotType::Masked"))
+		int32 StateMask;
+
+	/**
+	 * Smallest on-screen size, in pixels of the toggle's shorter side, the slot is still arranged and painted at.
+	 * Lets decorations drop out of small toggles, e.g. on a minimap. 0 always draws the slot.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Layout|Toggle Slot", AdvancedDisplay, meta = (ClampMin = "0"))
+		float MinimumDrawSize;
 public:
 #if WITH_EDITOR
 	virtual bool NudgeByDesigner(const FVector2D& NudgeDirection, const TOptional<int32>& GridSnapSize) override;
@@ -118,6 +129,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Layout|Toggle Slot")
 		EToggleSlotType GetSlotType() const;
 
+	/** Sets the check states the slot is shown in when its type is Masked */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Toggle Slot")
+		void SetStateMask(UPARAM(meta = (Bitmask, BitmaskEnum = "EToggleStateFlags")) int32 InStateMask);
+
+	/** Gets the check states the slot is shown in when its type is Masked */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Toggle Slot")
+		int32 GetStateMask() const;
+
+	/** Sets the smallest on-screen size the slot is drawn at */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Toggle Slot")
+		void SetMinimumDrawSize(float InMinimumDrawSize);
+
+	/** Gets the smallest on-screen size the slot is drawn at */
+	UFUNCTION(BlueprintCallable, Category = "Layout|Toggle Slot")
+		float GetMinimumDrawSize() const;
+
 public:
 
 	/** Sets the anchors on the slot */
@@ -130,7 +157,26 @@ public:
 
 public:
 
-	void BuildSlot(TSharedRef<SMyToggle> Canvas);
+	/**
+	 * Adds the slot to the toggle. With bDeferContent the content is replaced by a placeholder that keeps
+	 * the slot's layout until BuildPendingContent is called.
+	 */
+	void BuildSlot(TSharedRef<SMyToggle> Canvas, bool bDeferContent = false);
+
+	/** Whether the slot still shows a placeholder instead of its content. */
+	bool HasPendingContent() const
+	{
+		return bPendingContent;
+	}
+
+	/** Replaces the placeholder with the content's widget. */
+	void BuildPendingContent();
+
+	/** The Slate slot this slot was built into, null while it has no widget. */
+	const SMyToggle::FSlot* GetSlateSlot() const
+	{
+		return Slot;
+	}
 
 	// UPanelSlot interface
 	virtual void SynchronizeProperties() override;
@@ -154,8 +200,42 @@ public:
 	void RebaseLayout(bool PreserveSize = true);
 #endif
 
+private:
+	/** The owning toggle once the slot was fully synchronized, null while it is being set up. */
+	TSharedPtr<SMyToggle> GetToggleToInvalidate() const;
+
+	/** Writes to the Slate slot, remembers what was written and invalidates the toggle. Slot must be valid. */
+	void PushOffsets(const FMargin& InOffset);
+	void PushAnchors(const FAnchors& InAnchors);
+	void PushAlignment(const FVector2D& InAlignment);
+	void PushAutoSize(bool InbAutoSize);
+	void PushZOrder(int32 InZOrder);
+	void PushSlotType(EToggleSlotType InSlotType);
+	void PushStateMask(int32 InStateMask);
+	void PushMinimumDrawSize(float InMinimumDrawSize);
+
 private:
 	SMyToggle::FSlot* Slot;
+	TWeakPtr<SMyToggle> OwningToggle;
+	bool bPendingContent;
+
+	/** Values last written to Slot, SynchronizeProperties skips the ones that didn't change. */
+	struct FSyncedProperties
+	{
+		FMargin Offsets;
+		FAnchors Anchors;
+		FVector2D Alignment;
+		bool bAutoSize;
+		int32 ZOrder;
+		EToggleSlotType SlotType;
+		int32 StateMask;
+		float MinimumDrawSize;
+	};
+
+	FSyncedProperties Synced;
+
+	/** False until everything was pushed once to the current Slot. */
+	bool bSlotSynced;
 
 #if WITH_EDITORONLY_DATA
 	FGeometry PreEditGeometry;
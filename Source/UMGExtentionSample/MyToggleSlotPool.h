@@ -0,0 +1,326 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/Children.h"
+
+/**
+ * Pool handing out slots from contiguous blocks, so children of a panel sit next to each other
+ * in memory instead of being one heap allocation each. Addresses are stable until the slot is freed.
+ * Each panel owns its pool, slots of different panels never share a block. Game thread only.
+ * Blocks start small and double with the pool, so a toggle with a couple of children pays for a couple of slots.
+ */
+template<typename SlotType>
+class TMyToggleSlotPool : public FNoncopyable
+{
+public:
+	/** Size of the first block when nothing was reserved. */
+	static const int32 MinSlotsPerBlock = 2;
+	/** Largest block grown on its own, Reserve can ask for bigger ones. */
+	static const int32 MaxSlotsPerBlock = 64;
+
+	TMyToggleSlotPool()
+		: FreeList(nullptr)
+		, NumAllocated(0)
+		, NumCapacity(0)
+	{
+	}
+
+	~TMyToggleSlotPool()
+	{
+		check(NumAllocated == 0);
+		for (FBlock* Block : Blocks)
+		{
+			FMemory::Free(Block);
+		}
+	}
+
+	/** Makes sure the next NumSlots allocations come from blocks already allocated, in one block if a new one is needed. */
+	void Reserve(int32 NumSlots)
+	{
+		check(IsInGameThread());
+
+		const int32 NumFree = NumCapacity - NumAllocated;
+		if (NumSlots > NumFree)
+		{
+			AddBlock(FMath::Max(NumSlots - NumFree, MinSlotsPerBlock));
+		}
+	}
+
+	/** Returns uninitialized storage for one slot. */
+	void* Allocate()
+	{
+		check(IsInGameThread());
+
+		if (FreeList == nullptr)
+		{
+			AddBlock(FMath::Clamp(NumCapacity, MinSlotsPerBlock, MaxSlotsPerBlock));
+		}
+
+		FFreeNode* Node = FreeList;
+		FreeList = Node->Next;
+		++Blocks[FindBlockIndex(Node)]->NumUsed;
+		++NumAllocated;
+		return Node;
+	}
+
+	/** Returns storage obtained from Allocate, the slot must already be destructed. The block goes back to the heap once empty. */
+	void Free(void* Ptr)
+	{
+		check(IsInGameThread());
+
+		const int32 BlockIndex = FindBlockIndex(Ptr);
+		check(BlockIndex != INDEX_NONE);
+		FBlock* Block = Blocks[BlockIndex];
+		--NumAllocated;
+
+		if (--Block->NumUsed > 0)
+		{
+			FFreeNode* Node = (FFreeNode*)Ptr;
+			Node->Next = FreeList;
+			FreeList = Node;
+			return;
+		}
+
+		// Unlink the rest of the block's slots from the free list before releasing it.
+		for (FFreeNode** Link = &FreeList; *Link != nullptr;)
+		{
+			if (Block->Contains(*Link))
+			{
+				*Link = (*Link)->Next;
+			}
+			else
+			{
+				Link = &(*Link)->Next;
+			}
+		}
+		NumCapacity -= Block->NumSlots;
+		Blocks.RemoveAt(BlockIndex, 1, false);
+		FMemory::Free(Block);
+	}
+
+	template<typename... ArgTypes>
+	SlotType* New(ArgTypes&&... Args)
+	{
+		return new (Allocate()) SlotType(Forward<ArgTypes>(Args)...);
+	}
+
+	void Delete(SlotType* Slot)
+	{
+		Slot->~SlotType();
+		Free(Slot);
+	}
+
+	/** Whether Ptr was handed out by this pool. */
+	bool Owns(const void* Ptr) const
+	{
+		return FindBlockIndex(Ptr) != INDEX_NONE;
+	}
+
+	int32 GetNumAllocated() const
+	{
+		return NumAllocated;
+	}
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return NumCapacity * sizeof(SlotType) + Blocks.Num() * GetHeaderSize() + Blocks.GetAllocatedSize();
+	}
+
+private:
+	struct FFreeNode
+	{
+		FFreeNode* Next;
+	};
+
+	/** Header of a block, its NumSlots slots follow it in the same allocation. */
+	struct FBlock
+	{
+		int32 NumSlots;
+		int32 NumUsed;
+
+		SlotType* GetSlots()
+		{
+			return (SlotType*)((uint8*)this + GetHeaderSize());
+		}
+
+		bool Contains(const void* Ptr) const
+		{
+			const UPTRINT Slots = (UPTRINT)this + GetHeaderSize();
+			return (UPTRINT)Ptr >= Slots && (UPTRINT)Ptr < Slots + NumSlots * sizeof(SlotType);
+		}
+	};
+
+	static_assert(sizeof(SlotType) >= sizeof(FFreeNode), "Slot type is too small to be pooled.");
+
+	static SIZE_T GetHeaderSize()
+	{
+		return Align(sizeof(FBlock), alignof(SlotType));
+	}
+
+	void AddBlock(int32 NumSlots)
+	{
+		const uint32 Alignment = FMath::Max<uint32>(alignof(FBlock), alignof(SlotType));
+		FBlock* Block = (FBlock*)FMemory::Malloc(GetHeaderSize() + NumSlots * sizeof(SlotType), Alignment);
+		Block->NumSlots = NumSlots;
+		Block->NumUsed = 0;
+		NumCapacity += NumSlots;
+
+		// Blocks are kept sorted by address so Free finds the owner with a binary search.
+		int32 InsertIndex = 0;
+		while (InsertIndex < Blocks.Num() && (UPTRINT)Blocks[InsertIndex] < (UPTRINT)Block)
+		{
+			++InsertIndex;
+		}
+		Blocks.Insert(Block, InsertIndex);
+
+		// Thread the new block back to front so slots are handed out in address order.
+		SlotType* Slots = Block->GetSlots();
+		for (int32 Index = NumSlots - 1; Index >= 0; --Index)
+		{
+			FFreeNode* Node = (FFreeNode*)&Slots[Index];
+			Node->Next = FreeList;
+			FreeList = Node;
+		}
+	}
+
+	int32 FindBlockIndex(const void* Ptr) const
+	{
+		// Last block starting at or before Ptr.
+		int32 Low = 0;
+		int32 High = Blocks.Num();
+		while (Low < High)
+		{
+			const int32 Mid = (Low + High) / 2;
+			if ((UPTRINT)Blocks[Mid] <= (UPTRINT)Ptr)
+			{
+				Low = Mid + 1;
+			}
+			else
+			{
+				High = Mid;
+			}
+		}
+		return Low > 0 && Blocks[Low - 1]->Contains(Ptr) ? Low - 1 : INDEX_NONE;
+	}
+
+	/** Sorted by address. */
+	TArray<FBlock*> Blocks;
+	FFreeNode* FreeList;
+	int32 NumAllocated;
+	int32 NumCapacity;
+};
+
+/**
+ * Drop-in replacement for TPanelChildren whose slots added at runtime come from its own TMyToggleSlotPool.
+ * Declarative slots are allocated before the panel exists, they stay single heap allocations.
+ */
+template<typename SlotType>
+class TMyTogglePanelChildren : public FChildren
+{
+public:
+	typedef TMyToggleSlotPool<SlotType> FPool;
+
+	TMyTogglePanelChildren(SWidget* InOwner)
+		: FChildren(InOwner)
+	{
+	}
+
+	virtual ~TMyTogglePanelChildren()
+	{
+		Empty();
+	}
+
+	/** Allocates a slot for the declarative syntax, ownership passes to the container on Add. */
+	static SlotType* AllocateSlot()
+	{
+		return new SlotType();
+	}
+
+	/** Allocates a slot from this container's pool, it must be passed to Add right away. */
+	SlotType* AllocatePooledSlot()
+	{
+		return Pool.New();
+	}
+
+	virtual int32 Num() const override
+	{
+		return Slots.Num();
+	}
+
+	virtual TSharedRef<SWidget> GetChildAt(int32 Index) override
+	{
+		return Slots[Index]->GetWidget();
+	}
+
+	virtual TSharedRef<const SWidget> GetChildAt(int32 Index) const override
+	{
+		return Slots[Index]->GetWidget();
+	}
+
+	virtual const FSlotBase& GetSlotAt(int32 ChildIndex) const override
+	{
+		return *Slots[ChildIndex];
+	}
+
+	int32 Add(SlotType* Slot)
+	{
+		if (Owner)
+		{
+			Slot->AttachWidgetParent(Owner);
+		}
+		return Slots.Add(Slot);
+	}
+
+	void RemoveAt(int32 Index)
+	{
+		DeleteSlot(Slots[Index]);
+		Slots.RemoveAt(Index);
+	}
+
+	void Empty()
+	{
+		for (SlotType* Slot : Slots)
+		{
+			DeleteSlot(Slot);
+		}
+		Slots.Empty();
+	}
+
+	void Reserve(int32 NumToReserve)
+	{
+		Slots.Reserve(NumToReserve);
+	}
+
+	/** Reserves room for NumToAdd more slots allocated with AllocatePooledSlot. */
+	void ReservePooled(int32 NumToAdd)
+	{
+		Slots.Reserve(Slots.Num() + NumToAdd);
+		Pool.Reserve(NumToAdd);
+	}
+
+	SlotType& operator[](int32 Index) { return *Slots[Index]; }
+	const SlotType& operator[](int32 Index) const { return *Slots[Index]; }
+
+	SIZE_T GetAllocatedSize() const
+	{
+		return Slots.GetAllocatedSize() + Pool.GetAllocatedSize() + (Slots.Num() - Pool.GetNumAllocated()) * sizeof(SlotType);
+	}
+
+private:
+	void DeleteSlot(SlotType* Slot)
+	{
+		if (Pool.Owns(Slot))
+		{
+			Pool.Delete(Slot);
+		}
+		else
+		{
+			delete Slot;
+		}
+	}
+
+	FPool Pool;
+	TArray<SlotType*> Slots;
+};
@@ -0,0 +1,232 @@
+#include "MyToggleSnapshotLibrary.h"
+#include "MyToggle.h"
+#include "Blueprint/UserWidget.h"
+#include "Blueprint/WidgetTree.h"
+#include "Components/NamedSlotInterface.h"
+#include "Misc/Crc.h"
+#include "Algo/BinarySearch.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMyToggleSnapshot, Log, All);
+
+/** Version byte, then the toggle count. */
+static const int32 SnapshotHeaderSize = sizeof(uint8) + sizeof(int32);
+
+/////////////////////////////////////////////////////
+// FMyToggleStateSnapshot
+
+int32 FMyToggleStateSnapshot::Num() const
+{
+	int32 Count = 0;
+	if (Data.Num() >= SnapshotHeaderSize && Data[0] == Version)
+	{
+		FMemory::Memcpy(&Count, Data.GetData() + sizeof(uint8), sizeof(int32));
+	}
+	return FMath::Max(Count, 0);
+}
+
+/////////////////////////////////////////////////////
+// UMyToggleSnapshotLibrary
+
+UMyToggleSnapshotLibrary::UMyToggleSnapshotLibrary(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+FMyToggleStateSnapshot UMyToggleSnapshotLibrary::CaptureToggleStates(UWidget* Root)
+{
+	TArray<FKeyedToggle> Toggles;
+	GatherToggles(Root, 0, Toggles);
+	return Pack(Toggles);
+}
+
+int32 UMyToggleSnapshotLibrary::RestoreToggleStates(UWidget* Root, const FMyToggleStateSnapshot& Snapshot)
+{
+	TArray<FKeyedToggle> Toggles;
+	GatherToggles(Root, 0, Toggles);
+	return Unpack(Toggles, Snapshot);
+}
+
+FMyToggleStateSnapshot UMyToggleSnapshotLibrary::CaptureToggleGroup(const TArray<UMyToggle*>& Toggles)
+{
+	TArray<FKeyedToggle> KeyedToggles;
+	GatherToggleGroup(Toggles, KeyedToggles);
+	return Pack(KeyedToggles);
+}
+
+int32 UMyToggleSnapshotLibrary::RestoreToggleGroup(const TArray<UMyToggle*>& Toggles, const FMyToggleStateSnapshot& Snapshot)
+{
+	TArray<FKeyedToggle> KeyedToggles;
+	GatherToggleGroup(Toggles, KeyedToggles);
+	return Unpack(KeyedToggles, Snapshot);
+}
+
+uint32 UMyToggleSnapshotLibrary::HashWidgetName(const UWidget* Widget, uint32 ParentHash)
+{
+	// FName hashes depend on the name table of the run, the string CRC doesn't.
+	return FCrc::StrCrc32(*Widget->GetName(), ParentHash);
+}
+
+void UMyToggleSnapshotLibrary::GatherToggles(UWidget* Widget, uint32 Hash, TArray<FKeyedToggle>& OutToggles)
+{
+	if (Widget == nullptr)
+	{
+		return;
+	}
+
+	if (UMyToggle* Toggle = Cast<UMyToggle>(Widget))
+	{
+		OutToggles.Add(FKeyedToggle(Hash, Toggle));
+	}
+
+	if (INamedSlotInterface* NamedSlotHost = Cast<INamedSlotInterface>(Widget))
+	{
+		TArray<FName> SlotNames;
+		NamedSlotHost->GetSlotNames(SlotNames);
+		for (const FName& SlotName : SlotNames)
+		{
+			UWidget* Content = NamedSlotHost->GetContentForSlot(SlotName);
+			GatherToggles(Content, Content ? HashWidgetName(Content, Hash) : 0, OutToggles);
+		}
+	}
+
+	if (UPanelWidget* Panel = Cast<UPanelWidget>(Widget))
+	{
+		for (int32 ChildIndex = 0; ChildIndex < Panel->GetChildrenCount(); ++ChildIndex)
+		{
+			UWidget* Child = Panel->GetChildAt(ChildIndex);
+			GatherToggles(Child, Child ? HashWidgetName(Child, Hash) : 0, OutToggles);
+		}
+	}
+	else if (UUserWidget* UserWidget = Cast<UUserWidget>(Widget))
+	{
+		UWidget* TreeRoot = UserWidget->WidgetTree ? UserWidget->WidgetTree->RootWidget : nullptr;
+		GatherToggles(TreeRoot, TreeRoot ? HashWidgetName(TreeRoot, Hash) : 0, OutToggles);
+	}
+}
+
+uint32 UMyToggleSnapshotLibrary::HashWidgetPath(const UWidget* Widget)
+{
+	TArray<const UWidget*, TInlineAllocator<32>> Path;
+	while (Widget)
+	{
+		const UWidget* TreeRoot = Widget;
+		for (; Widget; Widget = Widget->GetParent())
+		{
+			Path.Add(Widget);
+			TreeRoot = Widget;
+		}
+
+		// Widgets of a user widget's tree are outered to it, step out to the user widget and its own parents.
+		Widget = TreeRoot->GetTypedOuter<UUserWidget>();
+	}
+
+	if (Path.Num() == 0)
+	{
+		return 0;
+	}
+
+	uint32 Hash = FCrc::StrCrc32(*Path.Last()->GetClass()->GetPathName());
+	for (int32 PathIndex = Path.Num() - 2; PathIndex >= 0; --PathIndex)
+	{
+		Hash = HashWidgetName(Path[PathIndex], Hash);
+	}
+	return Hash;
+}
+
+void UMyToggleSnapshotLibrary::GatherToggleGroup(const TArray<UMyToggle*>& Toggles, TArray<FKeyedToggle>& OutToggles)
+{
+	OutToggles.Reserve(Toggles.Num());
+
+	for (UMyToggle* Toggle : Toggles)
+	{
+		if (Toggle != nullptr)
+		{
+			OutToggles.Add(FKeyedToggle(HashWidgetPath(Toggle), Toggle));
+		}
+	}
+}
+
+FMyToggleStateSnapshot UMyToggleSnapshotLibrary::Pack(TArray<FKeyedToggle>& Toggles)
+{
+	Toggles.Sort([](const FKeyedToggle& A, const FKeyedToggle& B) { return A.Key < B.Key; });
+
+	// Toggles sharing a key can't be told apart on restore, none of them is stored.
+	int32 NumKept = 0;
+	for (int32 Index = 0; Index < Toggles.Num();)
+	{
+		int32 End = Index + 1;
+		while (End < Toggles.Num() && Toggles[End].Key == Toggles[Index].Key)
+		{
+			++End;
+		}
+
+		if (End - Index == 1)
+		{
+			Toggles[NumKept++] = Toggles[Index];
+		}
+		else
+		{
+			UE_LOG(LogMyToggleSnapshot, Warning, TEXT("%d toggles share the key of %s, their states are not captured"), End - Index, *Toggles[Index].Value->GetPathName());
+		}
+		Index = End;
+	}
+	Toggles.SetNum(NumKept, false);
+
+	const int32 Count = Toggles.Num();
+	const int32 HashesOffset = SnapshotHeaderSize;
+	const int32 StatesOffset = HashesOffset + Count * sizeof(uint32);
+
+	FMyToggleStateSnapshot Snapshot;
+	Snapshot.Data.SetNumZeroed(StatesOffset + (Count + 3) / 4);
+
+	uint8* Data = Snapshot.Data.GetData();
+	Data[0] = FMyToggleStateSnapshot::Version;
+	FMemory::Memcpy(Data + sizeof(uint8), &Count, sizeof(int32));
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		FMemory::Memcpy(Data + HashesOffset + Index * sizeof(uint32), &Toggles[Index].Key, sizeof(uint32));
+
+		const uint8 State = (uint8)Toggles[Index].Value->GetCheckedState() & 3;
+		Data[StatesOffset + Index / 4] |= State << ((Index % 4) * 2);
+	}
+
+	return Snapshot;
+}
+
+int32 UMyToggleSnapshotLibrary::Unpack(const TArray<FKeyedToggle>& Toggles, const FMyToggleStateSnapshot& Snapshot)
+{
+	const int32 Count = Snapshot.Num();
+
+	// The count comes from saved data, check it against the data size without overflowing.
+	const int64 RequiredSize = (int64)SnapshotHeaderSize + (int64)Count * sizeof(uint32) + ((int64)Count + 3) / 4;
+	if (Count <= 0 || RequiredSize > Snapshot.Data.Num())
+	{
+		return 0;
+	}
+
+	const int32 HashesOffset = SnapshotHeaderSize;
+	const int32 StatesOffset = HashesOffset + Count * sizeof(uint32);
+
+	TArray<uint32> Hashes;
+	Hashes.SetNumUninitialized(Count);
+	FMemory::Memcpy(Hashes.GetData(), Snapshot.Data.GetData() + HashesOffset, Count * sizeof(uint32));
+
+	const uint8* States = Snapshot.Data.GetData() + StatesOffset;
+
+	int32 NumRestored = 0;
+	for (const FKeyedToggle& Toggle : Toggles)
+	{
+		const int32 Index = Algo::BinarySearch(Hashes, Toggle.Key);
+		if (Index != INDEX_NONE)
+		{
+			const uint8 State = (States[Index / 4] >> ((Index % 4) * 2)) & 3;
+			if (Toggle.Value->RestoreCheckedState((ECheckBoxState)FMath::Min<uint8>(State, (uint8)ECheckBoxState::Undetermined)))
+			{
+				++NumRestored;
+			}
+		}
+	}
+
+	return NumRestored;
+}
@@ -0,0 +1,79 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "Kismet/BlueprintFunctionLibrary.h"
+#include "MyToggleSnapshotLibrary.generated.h"
+
+class UWidget;
+class UMyToggle;
+
+/**
+ * Checked states of a set of toggles: a format version byte, a count, the sorted path hashes of the toggles,
+ * then their states packed 2 bits each.
+ */
+USTRUCT(BlueprintType)
+struct UMGEXTENTIONSAMPLE_API FMyToggleStateSnapshot
+{
+	GENERATED_USTRUCT_BODY()
+
+	UPROPERTY(SaveGame)
+	TArray<uint8> Data;
+
+	/** Version of the Data layout, snapshots of other versions restore nothing. */
+	static const uint8 Version = 2;
+
+	/** Number of toggles stored, 0 for empty or unreadable data. */
+	int32 Num() const;
+};
+
+/**
+ * Captures and restores the checked state of many toggles at once. Toggles are keyed by a hash of the
+ * widget names from the capture root down to them, which stays the same across instances of a widget
+ * blueprint and across runs. Restoring writes to the models the toggles are bound to, but doesn't broadcast
+ * OnToggleCheckStateChanged. Toggles with a bound CheckedState are skipped.
+ */
+UCLASS()
+class UMGEXTENTIONSAMPLE_API UMyToggleSnapshotLibrary : public UBlueprintFunctionLibrary
+{
+	GENERATED_UCLASS_BODY()
+public:
+	/**
+	 * Captures every toggle under Root, descending into panels, named slots and user widgets. Keys start below Root,
+	 * so a screen created again, whose instance name changes, restores the states captured from the previous one
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Toggle|Snapshot")
+	static FMyToggleStateSnapshot CaptureToggleStates(UWidget* Root);
+
+	/** Restores the toggles under Root found in the snapshot, returns how many were restored */
+	UFUNCTION(BlueprintCallable, Category = "Toggle|Snapshot")
+	static int32 RestoreToggleStates(UWidget* Root, const FMyToggleStateSnapshot& Snapshot);
+
+	/** Captures a group of toggles, each keyed by its full path through the user widgets containing it */
+	UFUNCTION(BlueprintCallable, Category = "Toggle|Snapshot")
+	static FMyToggleStateSnapshot CaptureToggleGroup(const TArray<UMyToggle*>& Toggles);
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle|Snapshot")
+	static int32 RestoreToggleGroup(const TArray<UMyToggle*>& Toggles, const FMyToggleStateSnapshot& Snapshot);
+
+	/**
+	 * Hash of the widget names from the outermost user widget down to Widget. Past the root of a user widget's
+	 * tree it continues with the user widget itself, so repeated instances of a widget blueprint differ.
+	 * The outermost widget is usually made by CreateWidget and named after its creation count, its class path is used instead.
+	 */
+	static uint32 HashWidgetPath(const UWidget* Widget);
+
+private:
+	typedef TPair<uint32, UMyToggle*> FKeyedToggle;
+
+	/** Adds Widget if it is a toggle, keyed by Hash, and the toggles below it. */
+	static void GatherToggles(UWidget* Widget, uint32 Hash, TArray<FKeyedToggle>& OutToggles);
+	static void GatherToggleGroup(const TArray<UMyToggle*>& Toggles, TArray<FKeyedToggle>& OutToggles);
+
+	static uint32 HashWidgetName(const UWidget* Widget, uint32 ParentHash);
+
+	static FMyToggleStateSnapshot Pack(TArray<FKeyedToggle>& Toggles);
+	static int32 Unpack(const TArray<FKeyedToggle>& Toggles, const FMyToggleStateSnapshot& Snapshot);
+};
@@ -0,0 +1,120 @@
+#include "MyToggleSpatialIndex.h"
+
+/** Cells per axis are capped, a toggle doesn't have enough children to need more. */
+static const int32 MaxCellsPerAxis = 32;
+
+FMyToggleSpatialIndex::FMyToggleSpatialIndex()
+	: InvCellSize(FVector2D::ZeroVector)
+	, NumCellsX(0)
+	, NumCellsY(0)
+{
+}
+
+void FMyToggleSpatialIndex::Reset()
+{
+	Entries.Reset();
+	EntryByChild.Reset();
+	CellStarts.Reset();
+	CellEntries.Reset();
+	NumCellsX = 0;
+	NumCellsY = 0;
+}
+
+void FMyToggleSpatialIndex::Build(TArray<FEntry>& InEntries, int32 NumChildren)
+{
+	Reset();
+	Swap(Entries, InEntries);
+
+	EntryByChild.Init(INDEX_NONE, NumChildren);
+	if (Entries.Num() == 0)
+	{
+		return;
+	}
+
+	Bounds = Entries[0].Rect;
+	for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+	{
+		EntryByChild[Entries[EntryIndex].ChildIndex] = EntryIndex;
+		Bounds = Bounds.Expand(Entries[EntryIndex].Rect);
+	}
+
+	// About one child per cell if they were spread out evenly.
+	const int32 NumCellsPerAxis = FMath::Clamp(FMath::CeilToInt(FMath::Sqrt((float)Entries.Num())), 1, MaxCellsPerAxis);
+	const FVector2D BoundsSize = Bounds.GetSize();
+	NumCellsX = BoundsSize.X > KINDA_SMALL_NUMBER ? NumCellsPerAxis : 1;
+	NumCellsY = BoundsSize.Y > KINDA_SMALL_NUMBER ? NumCellsPerAxis : 1;
+	InvCellSize.X = BoundsSize.X > KINDA_SMALL_NUMBER ? NumCellsX / BoundsSize.X : 0.0f;
+	InvCellSize.Y = BoundsSize.Y > KINDA_SMALL_NUMBER ? NumCellsY / BoundsSize.Y : 0.0f;
+
+	// Count the entries per cell, turn the counts into starts, then fill.
+	CellStarts.Init(0, NumCellsX * NumCellsY + 1);
+	for (int32 Pass = 0; Pass < 2; ++Pass)
+	{
+		if (Pass == 1)
+		{
+			for (int32 CellIndex = 1; CellIndex < CellStarts.Num(); ++CellIndex)
+			{
+				CellStarts[CellIndex] += CellStarts[CellIndex - 1];
+			}
+			CellEntries.SetNumUninitialized(CellStarts.Last());
+		}
+
+		for (int32 EntryIndex = 0; EntryIndex < Entries.Num(); ++EntryIndex)
+		{
+			const FSlateRect& Rect = Entries[EntryIndex].Rect;
+			const int32 MinX = GetCellCoordinate(Rect.Left, Bounds.Left, InvCellSize.X, NumCellsX);
+			const int32 MaxX = GetCellCoordinate(Rect.Right, Bounds.Left, InvCellSize.X, NumCellsX);
+			const int32 MinY = GetCellCoordinate(Rect.Top, Bounds.Top, InvCellSize.Y, NumCellsY);
+			const int32 MaxY = GetCellCoordinate(Rect.Bottom, Bounds.Top, InvCellSize.Y, NumCellsY);
+
+			for (int32 Y = MinY; Y <= MaxY; ++Y)
+			{
+				for (int32 X = MinX; X <= MaxX; ++X)
+				{
+					const int32 CellIndex = Y * NumCellsX + X;
+					if (Pass == 0)
+					{
+						++CellStarts[CellIndex + 1];
+					}
+					else
+					{
+						// Starts are used as write cursors and shifted back below.
+						CellEntries[CellStarts[CellIndex]++] = EntryIndex;
+					}
+				}
+			}
+		}
+	}
+
+	for (int32 CellIndex = CellStarts.Num() - 1; CellIndex > 0; --CellIndex)
+	{
+		CellStarts[CellIndex] = CellStarts[CellIndex - 1];
+	}
+	CellStarts[0] = 0;
+}
+
+void FMyToggleSpatialIndex::QueryPoint(const FVector2D& Point, TArray<const FEntry*>& OutEntries) const
+{
+	if (Entries.Num() == 0 || !Bounds.ContainsPoint(Point))
+	{
+		return;
+	}
+
+	const int32 X = GetCellCoordinate(Point.X, Bounds.Left, InvCellSize.X, NumCellsX);
+	const int32 Y = GetCellCoordinate(Point.Y, Bounds.Top, InvCellSize.Y, NumCellsY);
+	const int32 CellIndex = Y * NumCellsX + X;
+
+	for (int32 Index = CellStarts[CellIndex]; Index < CellStarts[CellIndex + 1]; ++Index)
+	{
+		const FEntry& Entry = Entries[CellEntries[Index]];
+		if (Entry.Rect.ContainsPoint(Point))
+		{
+			OutEntries.Add(&Entry);
+		}
+	}
+}
+
+SIZE_T FMyToggleSpatialIndex::GetAllocatedSize() const
+{
+	return Entries.GetAllocatedSize() + EntryByChild.GetAllocatedSize() + CellStarts.GetAllocatedSize() + CellEntries.GetAllocatedSize();
+}
@@ -0,0 +1,59 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Layout/SlateRect.h"
+
+/**
+ * Uniform grid over the local rects of a panel's arranged children. Each child is stored in every cell
+ * its rect overlaps, so a point query only tests the few children of one cell.
+ */
+class UMGEXTENTIONSAMPLE_API FMyToggleSpatialIndex
+{
+public:
+	struct FEntry
+	{
+		int32 ChildIndex;
+		/** Position in paint order, higher is on top */
+		int32 PaintOrder;
+		FSlateRect Rect;
+	};
+
+	FMyToggleSpatialIndex();
+
+	/** Replaces the indexed children. NumChildren bounds the child indices. */
+	void Build(TArray<FEntry>& InEntries, int32 NumChildren);
+
+	void Reset();
+
+	/** The entry of a child, null if it isn't indexed. */
+	const FEntry* FindChild(int32 ChildIndex) const
+	{
+		const int32 EntryIndex = EntryByChild.IsValidIndex(ChildIndex) ? EntryByChild[ChildIndex] : INDEX_NONE;
+		return EntryIndex != INDEX_NONE ? &Entries[EntryIndex] : nullptr;
+	}
+
+	/** Adds the entries whose rect contains Point, in no particular order. */
+	void QueryPoint(const FVector2D& Point, TArray<const FEntry*>& OutEntries) const;
+
+	SIZE_T GetAllocatedSize() const;
+
+private:
+	int32 GetCellCoordinate(float Value, float Min, float InvCellSize, int32 NumCells) const
+	{
+		return FMath::Clamp(FMath::FloorToInt((Value - Min) * InvCellSize), 0, NumCells - 1);
+	}
+
+	TArray<FEntry> Entries;
+	TArray<int32> EntryByChild;
+
+	FSlateRect Bounds;
+	FVector2D InvCellSize;
+	int32 NumCellsX;
+	int32 NumCellsY;
+
+	/** Entries of cell i are CellEntries[CellStarts[i]] to CellEntries[CellStarts[i + 1] - 1]. */
+	TArray<int32> CellStarts;
+	TArray<int32> CellEntries;
+};
@@ -0,0 +1,131 @@
+#include "MyToggleStateMirror.h"
+#include "HAL/PlatformAtomics.h"
+
+FMyToggleStateMirror& FMyToggleStateMirror::Get()
+{
+	static FMyToggleStateMirror Mirror;
+	return Mirror;
+}
+
+FMyToggleStateMirror::FMyToggleStateMirror()
+{
+	for (TAtomic<FChunk*>& Chunk : Chunks)
+	{
+		Chunk = nullptr;
+	}
+}
+
+FMyToggleStateMirror::~FMyToggleStateMirror()
+{
+	for (TAtomic<FChunk*>& Chunk : Chunks)
+	{
+		delete Chunk.Exchange(nullptr);
+	}
+}
+
+FMyToggleStateMirror::FChunk* FMyToggleStateMirror::FindChunk(int32 Index) const
+{
+	const int32 ChunkIndex = Index / TogglesPerChunk;
+	return (Index >= 0 && ChunkIndex < MaxChunks) ? Chunks[ChunkIndex].Load() : nullptr;
+}
+
+FMyToggleStateMirror::FChunk* FMyToggleStateMirror::FindOrAddChunk(int32 Index)
+{
+	const int32 ChunkIndex = Index / TogglesPerChunk;
+	if (Index < 0 || ChunkIndex >= MaxChunks)
+	{
+		return nullptr;
+	}
+
+	FChunk* Chunk = Chunks[ChunkIndex].Load();
+	if (Chunk == nullptr)
+	{
+		Chunk = new FChunk;
+		FMemory::Memzero((void*)Chunk, sizeof(FChunk));
+		Chunks[ChunkIndex] = Chunk;
+	}
+
+	return Chunk;
+}
+
+void FMyToggleStateMirror::WriteBits(FChunk& Chunk, int32 Index, ECheckBoxState State)
+{
+	const int32 LocalIndex = Index % TogglesPerChunk;
+	volatile int32* Word = &Chunk.Words[LocalIndex / StatesPerWord];
+	const int32 Shift = (LocalIndex % StatesPerWord) * 2;
+	const int32 Mask = 3 << Shift;
+	const int32 Bits = ((int32)State & 3) << Shift;
+
+	// Neighbours in the word belong to other toggles, only swap our two bits.
+	int32 Old = FPlatformAtomics::AtomicRead(Word);
+	for (;;)
+	{
+		const int32 New = (Old & ~Mask) | Bits;
+		const int32 Previous = FPlatformAtomics::InterlockedCompareExchange(Word, New, Old);
+		if (Previous == Old)
+		{
+			break;
+		}
+		Old = Previous;
+	}
+}
+
+void FMyToggleStateMirror::Register(const FMyToggleHandle& Handle, ECheckBoxState State)
+{
+	check(IsInGameThread());
+
+	if (FChunk* Chunk = FindOrAddChunk(Handle.Index))
+	{
+		// State first, so a reader that sees the serial also sees the state.
+		WriteBits(*Chunk, Handle.Index, State);
+		FPlatformAtomics::InterlockedExchange(&Chunk->Serials[Handle.Index % TogglesPerChunk], Handle.Serial);
+	}
+}
+
+void FMyToggleStateMirror::Unregister(const FMyToggleHandle& Handle)
+{
+	check(IsInGameThread());
+
+	if (FChunk* Chunk = FindChunk(Handle.Index))
+	{
+		FPlatformAtomics::InterlockedCompareExchange(&Chunk->Serials[Handle.Index % TogglesPerChunk], 0, Handle.Serial);
+	}
+}
+
+void FMyToggleStateMirror::Write(const FMyToggleHandle& Handle, ECheckBoxState State)
+{
+	check(IsInGameThread());
+
+	FChunk* Chunk = FindChunk(Handle.Index);
+	if (Chunk && FPlatformAtomics::AtomicRead(&Chunk->Serials[Handle.Index % TogglesPerChunk]) == Handle.Serial)
+	{
+		WriteBits(*Chunk, Handle.Index, State);
+	}
+}
+
+bool FMyToggleStateMirror::TryRead(const FMyToggleHandle& Handle, ECheckBoxState& OutState) const
+{
+	const FChunk* Chunk = FindChunk(Handle.Index);
+	if (Chunk == nullptr)
+	{
+		return false;
+	}
+
+	const int32 LocalIndex = Handle.Index % TogglesPerChunk;
+	const volatile int32* Serial = &Chunk->Serials[LocalIndex];
+	if (FPlatformAtomics::AtomicRead(Serial) != Handle.Serial)
+	{
+		return false;
+	}
+
+	const int32 Word = FPlatformAtomics::AtomicRead(&Chunk->Words[LocalIndex / StatesPerWord]);
+
+	// The entry may have been handed to another toggle while reading.
+	if (FPlatformAtomics::AtomicRead(Serial) != Handle.Serial)
+	{
+		return false;
+	}
+
+	OutState = (ECheckBoxState)((Word >> ((LocalIndex % StatesPerWord) * 2)) & 3);
+	return true;
+}
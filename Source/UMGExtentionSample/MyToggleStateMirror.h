@@ -0,0 +1,66 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/Atomic.h"
+#include "Styling/SlateTypes.h"
+#include "MyToggleRegistry.h"
+
+/**
+ * Copy of toggle states that any thread can read without locks or touching a UObject.
+ * States are packed 2 bits per toggle in 32-bit words, indexed by toggle handle, and written by the
+ * game thread whenever a toggle with bMirrorState changes. Chunks are allocated as handles grow
+ * and never freed, so readers never race a reallocation.
+ */
+class UMGEXTENTIONSAMPLE_API FMyToggleStateMirror
+{
+public:
+	static FMyToggleStateMirror& Get();
+
+	~FMyToggleStateMirror();
+
+	/** Starts mirroring the toggle of Handle with State, game thread only. */
+	void Register(const FMyToggleHandle& Handle, ECheckBoxState State);
+
+	/** Stops mirroring, readers of Handle fail from then on. Game thread only. */
+	void Unregister(const FMyToggleHandle& Handle);
+
+	/** Publishes a new state, game thread only. */
+	void Write(const FMyToggleHandle& Handle, ECheckBoxState State);
+
+	/** Reads the last published state from any thread, false if Handle isn't mirrored. */
+	bool TryRead(const FMyToggleHandle& Handle, ECheckBoxState& OutState) const;
+
+	/** Reads the last published state from any thread, Default if Handle isn't mirrored. */
+	ECheckBoxState Read(const FMyToggleHandle& Handle, ECheckBoxState Default = ECheckBoxState::Unchecked) const
+	{
+		ECheckBoxState State;
+		return TryRead(Handle, State) ? State : Default;
+	}
+
+private:
+	enum
+	{
+		StatesPerWord = 16,
+		TogglesPerChunk = 16384,
+		WordsPerChunk = TogglesPerChunk / StatesPerWord,
+		MaxChunks = 1024,
+	};
+
+	struct FChunk
+	{
+		volatile int32 Words[WordsPerChunk];
+		/** Serial of the handle mirrored in each entry, 0 when unused. */
+		volatile int32 Serials[TogglesPerChunk];
+	};
+
+	FMyToggleStateMirror();
+
+	FChunk* FindChunk(int32 Index) const;
+	FChunk* FindOrAddChunk(int32 Index);
+
+	void WriteBits(FChunk& Chunk, int32 Index, ECheckBoxState State);
+
+	TAtomic<FChunk*> Chunks[MaxChunks];
+};
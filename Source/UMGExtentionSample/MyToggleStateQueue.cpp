@@ -0,0 +1,103 @@
+#include "MyToggleStateQueue.h"
+#include "MyToggle.h"
+#include "Framework/Application/SlateApplication.h"
+#include "Misc/CoreDelegates.h"
+
+FMyToggleStateQueue& FMyToggleStateQueue::Get()
+{
+	static FMyToggleStateQueue StateQueue;
+	return StateQueue;
+}
+
+FMyToggleStateQueue::FMyToggleStateQueue()
+{
+}
+
+void FMyToggleStateQueue::Enqueue(const FMyToggleHandle& Handle, ECheckBoxState State)
+{
+	if (Handle.IsValid())
+	{
+		FQueuedState Entry;
+		Entry.Handle = Handle;
+		Entry.State = State;
+		Queue.Enqueue(Entry);
+	}
+}
+
+void FMyToggleStateQueue::Initialize()
+{
+	check(IsInGameThread());
+
+	if (!PreTickHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		PreTickHandle = FSlateApplication::Get().OnPreTick().AddRaw(this, &FMyToggleStateQueue::OnSlatePreTick);
+	}
+
+	if (!PreExitHandle.IsValid())
+	{
+		PreExitHandle = FCoreDelegates::OnPreExit.AddRaw(this, &FMyToggleStateQueue::Shutdown);
+	}
+}
+
+void FMyToggleStateQueue::Shutdown()
+{
+	check(IsInGameThread());
+
+	Queue.Empty();
+	Coalesced.Empty();
+	CoalescedIndices.Empty();
+
+	if (PreTickHandle.IsValid() && FSlateApplication::IsInitialized())
+	{
+		FSlateApplication::Get().OnPreTick().Remove(PreTickHandle);
+	}
+	PreTickHandle.Reset();
+
+	FCoreDelegates::OnPreExit.Remove(PreExitHandle);
+	PreExitHandle.Reset();
+}
+
+void FMyToggleStateQueue::OnSlatePreTick(float DeltaTime)
+{
+	Drain();
+}
+
+void FMyToggleStateQueue::Drain()
+{
+	check(IsInGameThread());
+
+	if (Queue.IsEmpty())
+	{
+		return;
+	}
+
+	// Later entries for the same toggle overwrite earlier ones, a burst costs one change per toggle.
+	FQueuedState Entry;
+	while (Queue.Dequeue(Entry))
+	{
+		if (int32* Existing = CoalescedIndices.Find(Entry.Handle.Index))
+		{
+			Coalesced[*Existing] = Entry;
+		}
+		else
+		{
+			CoalescedIndices.Add(Entry.Handle.Index, Coalesced.Add(Entry));
+		}
+	}
+
+	// Broadcasts may queue more states or even drain again, so apply from a batch of our own.
+	TArray<FQueuedState> Batch = MoveTemp(Coalesced);
+	CoalescedIndices.Reset();
+
+	FMyToggleRegistry& Registry = FMyToggleRegistry::Get();
+	for (const FQueuedState& Queued : Batch)
+	{
+		if (UMyToggle* Toggle = Registry.Find(Queued.Handle))
+		{
+			Toggle->ApplyCheckedState(Queued.State);
+		}
+	}
+
+	Batch.Reset();
+	Coalesced = MoveTemp(Batch);
+}
@@ -0,0 +1,51 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Containers/Queue.h"
+#include "Styling/SlateTypes.h"
+#include "MyToggleRegistry.h"
+
+/**
+ * Lets any thread change toggle states without marshalling every change to the game thread itself.
+ * Entries go into a lock-free queue that the game thread drains once per frame before the Slate tick,
+ * only the last state queued for a toggle is applied and each toggle broadcasts its change once.
+ */
+class UMGEXTENTIONSAMPLE_API FMyToggleStateQueue
+{
+public:
+	static FMyToggleStateQueue& Get();
+
+	/** Queues a state for the toggle of Handle, safe to call from any thread. */
+	void Enqueue(const FMyToggleHandle& Handle, ECheckBoxState State);
+
+	/** Hooks the drain to the Slate pre tick, game thread only. Called when the first toggle handle is made. */
+	void Initialize();
+
+	/** Applies the queued states, game thread only. Runs every frame once initialized with Slate. */
+	void Drain();
+
+	/** Drops the queued states and unhooks from Slate. Runs on FCoreDelegates::OnPreExit once initialized. */
+	void Shutdown();
+
+private:
+	struct FQueuedState
+	{
+		FMyToggleHandle Handle;
+		ECheckBoxState State;
+	};
+
+	FMyToggleStateQueue();
+
+	void OnSlatePreTick(float DeltaTime);
+
+	TQueue<FQueuedState, EQueueMode::Mpsc> Queue;
+
+	/** Latest state per toggle while draining, kept to reuse its memory. */
+	TArray<FQueuedState> Coalesced;
+	TMap<int32, int32> CoalescedIndices;
+
+	FDelegateHandle PreTickHandle;
+	FDelegateHandle PreExitHandle;
+};
@@ -0,0 +1,233 @@
+#include "MyToggleTreeModel.h"
+#include "MyToggle.h"
+
+/////////////////////////////////////////////////////
+// UMyToggleTreeModel
+
+UMyToggleTreeModel::UMyToggleTreeModel(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer)
+{
+}
+
+int32 UMyToggleTreeModel::AddNode(int32 ParentNode)
+{
+	if (!Nodes.IsValidIndex(ParentNode))
+	{
+		ParentNode = INDEX_NONE;
+	}
+
+	const int32 NewNode = Nodes.AddUninitialized();
+	FNode& Node = Nodes[NewNode];
+	Node.Parent = ParentNode;
+	Node.FirstChild = INDEX_NONE;
+	Node.LastChild = INDEX_NONE;
+	Node.NextSibling = INDEX_NONE;
+	Node.NumChildren = 0;
+	Node.NumCheckedChildren = 0;
+	Node.NumUncheckedChildren = 0;
+	Node.State = ECheckBoxState::Unchecked;
+
+	if (ParentNode != INDEX_NONE)
+	{
+		FNode& Parent = Nodes[ParentNode];
+		if (Parent.LastChild != INDEX_NONE)
+		{
+			Nodes[Parent.LastChild].NextSibling = NewNode;
+		}
+		else
+		{
+			Parent.FirstChild = NewNode;
+		}
+		Parent.LastChild = NewNode;
+		++Parent.NumChildren;
+		++Parent.NumUncheckedChildren;
+
+		// A new unchecked child turns a checked parent undetermined, and a leaf parent into an aggregate.
+		const ECheckBoxState OldParentState = Parent.State;
+		Parent.State = AggregateState(Parent);
+		if (Parent.State != OldParentState)
+		{
+			TArray<int32> ChangedNodes;
+			ChangedNodes.Add(ParentNode);
+			PropagateUp(ParentNode, OldParentState, ChangedNodes);
+			NotifyChanged(ChangedNodes);
+		}
+	}
+
+	return NewNode;
+}
+
+void UMyToggleTreeModel::Reset()
+{
+	TArray<TWeakObjectPtr<UMyToggle>> BoundToggles;
+	Bindings.GenerateValueArray(BoundToggles);
+	for (const TWeakObjectPtr<UMyToggle>& Toggle : BoundToggles)
+	{
+		if (Toggle.IsValid())
+		{
+			Toggle->UnbindFromTreeModel();
+		}
+	}
+
+	Bindings.Reset();
+	Nodes.Reset();
+}
+
+int32 UMyToggleTreeModel::GetParent(int32 Node) const
+{
+	return Nodes.IsValidIndex(Node) ? Nodes[Node].Parent : INDEX_NONE;
+}
+
+TArray<int32> UMyToggleTreeModel::GetChildren(int32 Node) const
+{
+	TArray<int32> Children;
+	if (Nodes.IsValidIndex(Node))
+	{
+		Children.Reserve(Nodes[Node].NumChildren);
+		for (int32 Child = Nodes[Node].FirstChild; Child != INDEX_NONE; Child = Nodes[Child].NextSibling)
+		{
+			Children.Add(Child);
+		}
+	}
+	return Children;
+}
+
+ECheckBoxState UMyToggleTreeModel::GetState(int32 Node) const
+{
+	return Nodes.IsValidIndex(Node) ? Nodes[Node].State : ECheckBoxState::Unchecked;
+}
+
+void UMyToggleTreeModel::SetState(int32 Node, ECheckBoxState State)
+{
+	if (!Nodes.IsValidIndex(Node) || Nodes[Node].State == State)
+	{
+		return;
+	}
+
+	// A parent that is Checked or Unchecked already has its whole subtree in that state, so the early out
+	// above also covers the cascade.
+	const bool bIsParent = Nodes[Node].NumChildren > 0;
+	if (bIsParent && State == ECheckBoxState::Undetermined)
+	{
+		return;
+	}
+
+	const ECheckBoxState OldState = Nodes[Node].State;
+	TArray<int32> ChangedNodes;
+
+	if (bIsParent)
+	{
+		const bool bChecked = State == ECheckBoxState::Checked;
+
+		TArray<int32, TInlineAllocator<64>> Stack;
+		Stack.Add(Node);
+		while (Stack.Num() > 0)
+		{
+			const int32 Current = Stack.Pop(false);
+			FNode& CurrentNode = Nodes[Current];
+
+			if (CurrentNode.State != State)
+			{
+				CurrentNode.State = State;
+				ChangedNodes.Add(Current);
+			}
+			else if (CurrentNode.NumChildren > 0)
+			{
+				// Subtree already settled in this state.
+				continue;
+			}
+
+			CurrentNode.NumCheckedChildren = bChecked ? CurrentNode.NumChildren : 0;
+			CurrentNode.NumUncheckedChildren = bChecked ? 0 : CurrentNode.NumChildren;
+
+			for (int32 Child = CurrentNode.FirstChild; Child != INDEX_NONE; Child = Nodes[Child].NextSibling)
+			{
+				Stack.Add(Child);
+			}
+		}
+	}
+	else
+	{
+		Nodes[Node].State = State;
+		ChangedNodes.Add(Node);
+	}
+
+	PropagateUp(Node, OldState, ChangedNodes);
+	NotifyChanged(ChangedNodes);
+}
+
+ECheckBoxState UMyToggleTreeModel::AggregateState(const FNode& InNode)
+{
+	if (InNode.NumChildren == 0)
+	{
+		return InNode.State;
+	}
+	if (InNode.NumCheckedChildren == InNode.NumChildren)
+	{
+		return ECheckBoxState::Checked;
+	}
+	if (InNode.NumUncheckedChildren == InNode.NumChildren)
+	{
+		return ECheckBoxState::Unchecked;
+	}
+	return ECheckBoxState::Undetermined;
+}
+
+void UMyToggleTreeModel::PropagateUp(int32 Child, ECheckBoxState OldState, TArray<int32>& OutChanged)
+{
+	for (int32 ParentIndex = Nodes[Child].Parent; ParentIndex != INDEX_NONE; ParentIndex = Nodes[Child].Parent)
+	{
+		FNode& Parent = Nodes[ParentIndex];
+		const ECheckBoxState NewState = Nodes[Child].State;
+
+		Parent.NumCheckedChildren += (NewState == ECheckBoxState::Checked) - (OldState == ECheckBoxState::Checked);
+		Parent.NumUncheckedChildren += (NewState == ECheckBoxState::Unchecked) - (OldState == ECheckBoxState::Unchecked);
+
+		const ECheckBoxState OldParentState = Parent.State;
+		Parent.State = AggregateState(Parent);
+		if (Parent.State == OldParentState)
+		{
+			break;
+		}
+
+		OutChanged.Add(ParentIndex);
+		Child = ParentIndex;
+		OldState = OldParentState;
+	}
+}
+
+void UMyToggleTreeModel::NotifyChanged(const TArray<int32>& ChangedNodes)
+{
+	if (Bindings.Num() > 0)
+	{
+		TArray<TWeakObjectPtr<UMyToggle>, TInlineAllocator<4>> BoundToggles;
+		for (int32 Node : ChangedNodes)
+		{
+			BoundToggles.Reset();
+			Bindings.MultiFind(Node, BoundToggles);
+
+			for (const TWeakObjectPtr<UMyToggle>& Toggle : BoundToggles)
+			{
+				if (Toggle.IsValid())
+				{
+					Toggle->SetCheckedState(Nodes[Node].State);
+				}
+			}
+		}
+	}
+
+	OnNodesChanged.Broadcast(ChangedNodes);
+}
+
+void UMyToggleTreeModel::Bind(UMyToggle* Toggle, int32 Node)
+{
+	if (Toggle)
+	{
+		Bindings.AddUnique(Node, Toggle);
+	}
+}
+
+void UMyToggleTreeModel::Unbind(UMyToggle* Toggle, int32 Node)
+{
+	Bindings.RemoveSingle(Node, Toggle);
+}
@@ -0,0 +1,89 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/ObjectMacros.h"
+#include "UObject/Object.h"
+#include "Styling/SlateTypes.h"
+#include "MyToggleTreeModel.generated.h"
+
+class UMyToggle;
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnToggleNodesChanged, const TArray<int32>&, ChangedNodes);
+
+/**
+ * Tree of tri-state toggles where a parent is Checked or Unchecked when all its children are,
+ * and Undetermined otherwise. Each node keeps how many of its children are checked and unchecked,
+ * so a change only walks up its ancestors while they change, and setting a parent applies to its
+ * whole subtree in one batch.
+ */
+UCLASS(BlueprintType)
+class UMGEXTENTIONSAMPLE_API UMyToggleTreeModel : public UObject
+{
+	GENERATED_UCLASS_BODY()
+public:
+	/** Called once per operation with every node whose state changed */
+	UPROPERTY(BlueprintAssignable, Category = "Toggle Model|Event")
+	FOnToggleNodesChanged OnNodesChanged;
+
+public:
+	/** Adds an unchecked node under ParentNode, or a root if ParentNode is INDEX_NONE, and returns its index */
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	int32 AddNode(int32 ParentNode = -1);
+
+	/** Removes every node, bound toggles are unbound */
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	void Reset();
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	int32 Num() const
+	{
+		return Nodes.Num();
+	}
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	int32 GetParent(int32 Node) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	TArray<int32> GetChildren(int32 Node) const;
+
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	ECheckBoxState GetState(int32 Node) const;
+
+	/**
+	 * Sets a node and, for Checked or Unchecked, its whole subtree, then updates its ancestors.
+	 * Undetermined can only be set on leaves, the state of a parent follows its children.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Toggle Model")
+	void SetState(int32 Node, ECheckBoxState State);
+
+	/** Keeps the toggle's checked state in sync with a node, use UMyToggle::BindToTreeModel */
+	void Bind(UMyToggle* Toggle, int32 Node);
+	void Unbind(UMyToggle* Toggle, int32 Node);
+
+private:
+	struct FNode
+	{
+		int32 Parent;
+		int32 FirstChild;
+		int32 LastChild;
+		int32 NextSibling;
+		int32 NumChildren;
+		int32 NumCheckedChildren;
+		int32 NumUncheckedChildren;
+		ECheckBoxState State;
+	};
+
+	/** State of a parent from its child counts. */
+	static ECheckBoxState AggregateState(const FNode& InNode);
+
+	/** Moves Child from OldState to its current state in its parent's counts, and so on up while parents change. */
+	void PropagateUp(int32 Child, ECheckBoxState OldState, TArray<int32>& OutChanged);
+
+	void NotifyChanged(const TArray<int32>& ChangedNodes);
+
+	TArray<FNode> Nodes;
+
+	TMultiMap<int32, TWeakObjectPtr<UMyToggle>> Bindings;
+};
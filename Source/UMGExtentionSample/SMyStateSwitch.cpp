@@ -0,0 +1,473 @@
+#include "SMyStateSwitch.h"
+#include "MyToggleLayout.h"
+#include "Types/PaintArgs.h"
+#include "Layout/ArrangedChildren.h"
+#include "SlateSettings.h"
+#include "Framework/Application/SlateApplication.h"
+
+
+SMyStateSwitch::SMyStateSwitch()
+	: Children(this)
+	, NumStates(1)
+	, bStateBucketsDirty(true)
+	, bHasBoundZOrder(false)
+	, PaintArrangedChildren(EVisibility::Visible)
+{
+	SetCanTick(false);
+	bCanSupportFocus = true;
+	bHasCustomPrepass = true;
+}
+
+void SMyStateSwitch::Construct(const SMyStateSwitch::FArguments& InArgs)
+{
+	const int32 NumSlots = InArgs.Slots.Num();
+	Children.Reserve(NumSlots);
+	for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
+	{
+		Children.Add(InArgs.Slots[SlotIndex]);
+	}
+
+	StateIndex = InArgs._StateIndex;
+	NumStates = FMath::Max(InArgs._NumStates, 1);
+	CycleOrder = InArgs._CycleOrder;
+	bIsFocusable = InArgs._IsFocusable;
+	OnStateChanged = InArgs._OnStateChanged;
+	ClickMethod = InArgs._ClickMethod.Get();
+
+	bIsPressed = false;
+
+	RebuildNextStates();
+	InvalidateStateBuckets();
+}
+
+void SMyStateSwitch::ClearChildren()
+{
+	if (Children.Num())
+	{
+		Invalidate(EInvalidateWidget::Layout);
+		InvalidateStateBuckets();
+		Children.Empty();
+	}
+}
+
+int32 SMyStateSwitch::RemoveSlot(const TSharedRef<SWidget>& SlotWidget)
+{
+	Invalidate(EInvalidateWidget::Layout);
+	InvalidateStateBuckets();
+	for (int32 SlotIdx = 0; SlotIdx < Children.Num(); ++SlotIdx)
+	{
+		if (SlotWidget == Children[SlotIdx].GetWidget())
+		{
+			Children.RemoveAt(SlotIdx);
+			return SlotIdx;
+		}
+	}
+
+	return -1;
+}
+
+int32 SMyStateSwitch::RemoveSlot(const FSlot* SlotToRemove)
+{
+	for (int32 SlotIdx = 0; SlotIdx < Children.Num(); ++SlotIdx)
+	{
+		if (&Children[SlotIdx] == SlotToRemove)
+		{
+			Invalidate(EInvalidateWidget::Layout);
+			InvalidateStateBuckets();
+			Children.RemoveAt(SlotIdx);
+			return SlotIdx;
+		}
+	}
+
+	return -1;
+}
+
+void SMyStateSwitch::SetStateIndex(TAttribute<int32> InStateIndex)
+{
+	StateIndex = InStateIndex;
+	Invalidate(EInvalidateWidget::Layout);
+}
+
+void SMyStateSwitch::SetNumStates(int32 InNumStates)
+{
+	InNumStates = FMath::Max(InNumStates, 1);
+	if (NumStates != InNumStates)
+	{
+		NumStates = InNumStates;
+		RebuildNextStates();
+		InvalidateStateBuckets();
+		Invalidate(EInvalidateWidget::Layout);
+	}
+}
+
+void SMyStateSwitch::SetCycleOrder(const TArray<int32>& InCycleOrder)
+{
+	CycleOrder = InCycleOrder;
+	RebuildNextStates();
+}
+
+void SMyStateSwitch::RebuildNextStates()
+{
+	NextStates.SetNumUninitialized(NumStates);
+
+	// States missing from the cycle order jump back to its first entry.
+	const int32 FirstState = CycleOrder.Num() > 0 ? CycleOrder[0] : 0;
+	for (int32 State = 0; State < NumStates; ++State)
+	{
+		NextStates[State] = CycleOrder.Num() > 0 ? FirstState : (State + 1) % NumStates;
+	}
+
+	for (int32 OrderIndex = 0; OrderIndex < CycleOrder.Num(); ++OrderIndex)
+	{
+		const int32 State = CycleOrder[OrderIndex];
+		if (NextStates.IsValidIndex(State))
+		{
+			NextStates[State] = CycleOrder[(OrderIndex + 1) % CycleOrder.Num()];
+		}
+	}
+}
+
+int32 SMyStateSwitch::GetNextState(int32 InStateIndex) const
+{
+	if (NextStates.IsValidIndex(InStateIndex))
+	{
+		return NextStates[InStateIndex];
+	}
+
+	return CycleOrder.Num() > 0 ? CycleOrder[0] : 0;
+}
+
+void SMyStateSwitch::CycleState()
+{
+	const int32 NewState = GetNextState(StateIndex.Get());
+
+	if (!StateIndex.IsBound())
+	{
+		// When we are not bound, just switch the current state.
+		StateIndex.Set(NewState);
+		Invalidate(EInvalidateWidget::Layout);
+	}
+
+	OnStateChanged.ExecuteIfBound(NewState);
+}
+
+void SMyStateSwitch::InvalidateStateBuckets()
+{
+	bStateBucketsDirty = true;
+}
+
+void SMyStateSwitch::InvalidateSlotOrder()
+{
+	InvalidateStateBuckets();
+	Invalidate(EInvalidateWidget::Paint);
+}
+
+void SMyStateSwitch::InvalidateSlotStates()
+{
+	InvalidateStateBuckets();
+	Invalidate(EInvalidateWidget::Layout);
+}
+
+bool SMyStateSwitch::IsSlotShown(const FSlot& Slot) const
+{
+	return Slot.StateIndex == INDEX_NONE || Slot.StateIndex == StateIndex.Get();
+}
+
+void SMyStateSwitch::InvalidateSlotDesiredSize(const FSlot& Slot)
+{
+	if (IsSlotShown(Slot))
+	{
+		Invalidate(EInvalidateWidget::Layout);
+	}
+}
+
+void SMyStateSwitch::InvalidateSlotGeometry(const FSlot& Slot)
+{
+	if (IsSlotShown(Slot))
+	{
+		Invalidate(EInvalidateWidget::Paint);
+	}
+}
+
+void SMyStateSwitch::InvalidateSlotOffset(const FSlot& Slot, const FMargin& OldOffset)
+{
+	if (IsSlotShown(Slot))
+	{
+		Invalidate(MyToggleLayout::DoesOffsetChangeDesiredSize(Slot, OldOffset) ? EInvalidateWidget::Layout : EInvalidateWidget::Paint);
+	}
+}
+
+struct FStateSwitchChildZOrder
+{
+	int32 ChildIndex;
+	float ZOrder;
+};
+
+struct FStateSwitchSortSlotsByZOrder
+{
+	FORCEINLINE bool operator()(const FStateSwitchChildZOrder& A, const FStateSwitchChildZOrder& B) const
+	{
+		return A.ZOrder == B.ZOrder ? A.ChildIndex < B.ChildIndex : A.ZOrder < B.ZOrder;
+	}
+};
+
+void SMyStateSwitch::RebuildStateBuckets() const
+{
+	bStateBucketsDirty = false;
+	bHasBoundZOrder = false;
+
+	StateBuckets.SetNum(NumStates + 1);
+	for (FStateBucket& Bucket : StateBuckets)
+	{
+		Bucket.Reset();
+	}
+
+	FMemMark Mark(FMemStack::Get());
+	TArray< FStateSwitchChildZOrder, TMemStackAllocator<> > SlotOrder;
+	SlotOrder.Reserve(Children.Num());
+
+	for (int32 ChildIndex = 0; ChildIndex < Children.Num(); ++ChildIndex)
+	{
+		FStateSwitchChildZOrder Order;
+		Order.ChildIndex = ChildIndex;
+		Order.ZOrder = Children[ChildIndex].ZOrderAttr.Get();
+		SlotOrder.Add(Order);
+
+		bHasBoundZOrder |= Children[ChildIndex].ZOrderAttr.IsBound();
+	}
+
+	SlotOrder.Sort(FStateSwitchSortSlotsByZOrder());
+
+	// Walking the children in z-order keeps every bucket sorted.
+	for (const FStateSwitchChildZOrder& Order : SlotOrder)
+	{
+		const int32 SlotState = Children[Order.ChildIndex].StateIndex;
+		if (SlotState == INDEX_NONE)
+		{
+			for (FStateBucket& Bucket : StateBuckets)
+			{
+				Bucket.Add(Order.ChildIndex);
+			}
+		}
+		else if (SlotState >= 0 && SlotState < NumStates)
+		{
+			StateBuckets[SlotState].Add(Order.ChildIndex);
+		}
+	}
+}
+
+const SMyStateSwitch::FStateBucket& SMyStateSwitch::GetActiveBucket() const
+{
+	if (bStateBucketsDirty || bHasBoundZOrder)
+	{
+		RebuildStateBuckets();
+	}
+
+	const int32 State = StateIndex.Get();
+	return StateBuckets[(State >= 0 && State < NumStates) ? State : NumStates];
+}
+
+void SMyStateSwitch::ArrangeLayeredChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren, FArrangedChildLayers& ArrangedChildLayers) const
+{
+	if (Children.Num() <= 0)
+		return;
+
+#if WITH_EDITOR
+	const bool bExplicitChildZOrder = GetDefault<USlateSettings>()->bExplicitCanvasChildZOrder;
+#else
+	const static bool bExplicitChildZOrder = GetDefault<USlateSettings>()->bExplicitCanvasChildZOrder;
+#endif
+
+	const FStateBucket& Bucket = GetActiveBucket();
+	float LastZOrder = -FLT_MAX;
+
+	for (int32 BucketIndex = 0; BucketIndex < Bucket.Num(); ++BucketIndex)
+	{
+		const SMyStateSwitch::FSlot& CurSlot = Children[Bucket[BucketIndex]];
+		const TSharedRef<SWidget>& CurWidget = CurSlot.GetWidget();
+
+		const EVisibility ChildVisibility = CurWidget->GetVisibility();
+		if (!ArrangedChildren.Accepts(ChildVisibility))
+			continue;
+
+		FVector2D LocalPosition, LocalSize;
+		MyToggleLayout::ArrangeSlot(AllottedGeometry.GetLocalSize(), CurSlot, LocalPosition, LocalSize);
+
+		ArrangedChildren.AddWidget(ChildVisibility,
+			AllottedGeometry.MakeChild(CurWidget, LocalPosition, LocalSize));
+
+		bool bNewLayer = true;
+		if (bExplicitChildZOrder)
+		{
+			bNewLayer = false;
+			const float ZOrder = CurSlot.ZOrderAttr.Get();
+			if (ZOrder > LastZOrder + DELTA)
+			{
+				if (ArrangedChildLayers.Num() > 0)
+				{
+					bNewLayer = true;
+				}
+				LastZOrder = ZOrder;
+			}
+		}
+
+		ArrangedChildLayers.Add(bNewLayer);
+	}
+}
+
+void SMyStateSwitch::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren) const
+{
+	FArrangedChildLayers ChildLayers;
+	ArrangeLayeredChildren(AllottedGeometry, ArrangedChildren, ChildLayers);
+}
+
+int32 SMyStateSwitch::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
+{
+	SCOPED_NAMED_EVENT_TEXT("SMyStateSwitch", FColor::Cyan);
+	FArrangedChildLayers ChildLayers;
+	FArrangedChildren& ArrangedChildren = PaintArrangedChildren;
+	ArrangedChildren.GetInternalArray().Reset();
+	ArrangeLayeredChildren(AllottedGeometry, ArrangedChildren, ChildLayers);
+	const bool bForwardedEnabled = ShouldBeEnabled(bParentEnabled);
+
+	int32 MaxLayerId = LayerId;
+	int32 ChildLayerId = LayerId;
+
+	const FPaintArgs NewArgs = Args.WithNewParent(this);
+
+	for (int32 ChildIndex = 0; ChildIndex < ArrangedChildren.Num(); ++ChildIndex)
+	{
+		FArrangedWidget& CurWidget = ArrangedChildren[ChildIndex];
+		if (!IsChildWidgetCulled(MyCullingRect, CurWidget))
+		{
+			ChildLayerId = ChildLayers[ChildIndex] ? MaxLayerId + 1 : ChildLayerId;
+			const int32 CurWidgetsMaxLayerId = CurWidget.Widget->Paint(NewArgs,
+				CurWidget.Geometry, MyCullingRect, OutDrawElements,
+				ChildLayerId, InWidgetStyle, bForwardedEnabled);
+			MaxLayerId = FMath::Max(MaxLayerId, CurWidgetsMaxLayerId);
+		}
+	}
+
+	// Keep the capacity for the next frame but don't hold on to the child widgets.
+	ArrangedChildren.GetInternalArray().Reset();
+
+	return MaxLayerId;
+}
+
+FVector2D SMyStateSwitch::ComputeDesiredSize(float) const
+{
+	FVector2D FinalDesiredSize(0, 0);
+
+	const FStateBucket& Bucket = GetActiveBucket();
+	for (int32 BucketIndex = 0; BucketIndex < Bucket.Num(); ++BucketIndex)
+	{
+		const SMyStateSwitch::FSlot& CurChild = Children[Bucket[BucketIndex]];
+
+		// As long as the widgets are not collapsed, they should contribute to the desired size.
+		if (CurChild.GetWidget()->GetVisibility() != EVisibility::Collapsed)
+		{
+			MyToggleLayout::AccumulateDesiredSize(CurChild, FinalDesiredSize);
+		}
+	}
+
+	return FinalDesiredSize;
+}
+
+bool SMyStateSwitch::CustomPrepass(float LayoutScaleMultiplier)
+{
+	// Only the active state's children take part in layout, see SMyToggle::CustomPrepass.
+	const FStateBucket& Bucket = GetActiveBucket();
+	for (int32 BucketIndex = 0; BucketIndex < Bucket.Num(); ++BucketIndex)
+	{
+		const TSharedRef<SWidget>& Widget = Children[Bucket[BucketIndex]].GetWidget();
+		if (Widget->GetVisibility() != EVisibility::Collapsed)
+		{
+			Widget->SlatePrepass(LayoutScaleMultiplier);
+		}
+	}
+
+	return false;
+}
+
+bool SMyStateSwitch::SupportsKeyboardFocus() const
+{
+	return bIsFocusable;
+}
+
+FReply SMyStateSwitch::OnKeyUp(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent)
+{
+	if (InKeyEvent.GetKey() == EKeys::Enter
+		|| InKeyEvent.GetKey() == EKeys::SpaceBar
+		|| InKeyEvent.GetKey() == EKeys::Virtual_Accept)
+	{
+		CycleState();
+		return FReply::Handled();
+	}
+
+	return FReply::Unhandled();
+}
+
+FReply SMyStateSwitch::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (MouseEvent.GetEffectingButton() == EKeys::LeftMouseButton)
+	{
+		bIsPressed = true;
+
+		if (ClickMethod == EButtonClickMethod::MouseDown)
+		{
+			CycleState();
+
+			// Set focus to this switch, but don't capture the mouse
+			return FReply::Handled().SetUserFocus(AsShared(), EFocusCause::Mouse);
+		}
+		else
+		{
+			// Capture the mouse, and also set focus to this switch
+			return FReply::Handled().CaptureMouse(AsShared()).SetUserFocus(AsShared(), EFocusCause::Mouse);
+		}
+	}
+
+	return FReply::Unhandled();
+}
+
+FReply SMyStateSwitch::OnMouseButtonDoubleClick(const FGeometry& InMyGeometry, const FPointerEvent& InMouseEvent)
+{
+	return OnMouseButtonDown(InMyGeometry, InMouseEvent);
+}
+
+FReply SMyStateSwitch::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (MouseEvent.GetEffectingButton() == EKeys::LeftMouseButton)
+	{
+		bIsPressed = false;
+
+		if (ClickMethod != EButtonClickMethod::MouseDown)
+		{
+			const bool IsUnderMouse = MyGeometry.IsUnderLocation(MouseEvent.GetScreenSpacePosition());
+			if (IsUnderMouse && (ClickMethod == EButtonClickMethod::MouseUp || HasMouseCapture()))
+			{
+				CycleState();
+			}
+		}
+
+		return FReply::Handled().ReleaseMouseCapture();
+	}
+
+	return FReply::Unhandled();
+}
+
+void SMyStateSwitch::OnMouseLeave(const FPointerEvent& MouseEvent)
+{
+	SWidget::OnMouseLeave(MouseEvent);
+
+	// See SMyToggle::OnMouseLeave, without capture we may never get the mouse up.
+	if (ClickMethod == EButtonClickMethod::MouseDown)
+	{
+		bIsPressed = false;
+	}
+}
+
+bool SMyStateSwitch::IsInteractable() const
+{
+	return IsEnabled();
+}
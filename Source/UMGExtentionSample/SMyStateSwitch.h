@@ -0,0 +1,251 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Styling/SlateTypes.h"
+#include "Misc/Attribute.h"
+#include "Layout/Margin.h"
+#include "Layout/Geometry.h"
+#include "Layout/ArrangedChildren.h"
+#include "Widgets/DeclarativeSyntaxSupport.h"
+#include "SlotBase.h"
+#include "Widgets/SWidget.h"
+#include "Widgets/SPanel.h"
+#include "Widgets/Layout/Anchors.h"
+#include "Input/Reply.h"
+#include "Misc/MemStack.h"
+#include "MyToggleSlotPool.h"
+
+DECLARE_DELEGATE_OneParam(FOnStateSwitchChanged, int32);
+
+/**
+ * Generalization of SMyToggle to any number of states. Every slot belongs to one state index, or to all
+ * of them, and only the children of the active state are prepassed, arranged and painted.
+ * Children are bucketed per state and pre-sorted by z-order, so switching state is O(1).
+ */
+class UMGEXTENTIONSAMPLE_API SMyStateSwitch : public SPanel
+{
+public:
+	class FSlot : public TSlotBase<FSlot>
+	{
+	public:
+		/** Offset */
+		TAttribute<FMargin> OffsetAttr;
+
+		/** Anchors */
+		TAttribute<FAnchors> AnchorsAttr;
+
+		/** Size */
+		TAttribute<FVector2D> AlignmentAttr;
+
+		/** Auto-Size */
+		TAttribute<bool> AutoSizeAttr;
+
+		/** Z-Order, sorting is cached per state so call InvalidateSlotOrder after changing it. Bound z-orders are re-sorted every arrange */
+		TAttribute<float> ZOrderAttr;
+
+		/** State this slot is shown in, INDEX_NONE for all states. Call InvalidateSlotStates after changing it */
+		int32 StateIndex;
+
+		FSlot()
+			: TSlotBase<FSlot>()
+			, OffsetAttr(FMargin(0, 0, 1, 1))
+			, AnchorsAttr(FAnchors(0.0f, 0.0f))
+			, AlignmentAttr(FVector2D(0.5f, 0.5f))
+			, AutoSizeAttr(false)
+			, ZOrderAttr(0)
+			, StateIndex(INDEX_NONE)
+		{
+		}
+
+		FSlot& Offset(const TAttribute<FMargin>& InOffset)
+		{
+			OffsetAttr = InOffset;
+			return *this;
+		}
+
+		FSlot& Anchors(const TAttribute<FAnchors>& InAnchors)
+		{
+			AnchorsAttr = InAnchors;
+			return *this;
+		}
+
+		FSlot& Alignment(const TAttribute<FVector2D>& InAlignment)
+		{
+			AlignmentAttr = InAlignment;
+			return *this;
+		}
+
+		FSlot& AutoSize(const TAttribute<bool>& InAutoSize)
+		{
+			AutoSizeAttr = InAutoSize;
+			return *this;
+		}
+
+		FSlot& ZOrder(const TAttribute<float>& InZOrder)
+		{
+			ZOrderAttr = InZOrder;
+			return *this;
+		}
+
+		FSlot& State(int32 InStateIndex)
+		{
+			StateIndex = InStateIndex;
+			return *this;
+		}
+
+		FSlot& Expose(FSlot*& OutVarToInit)
+		{
+			OutVarToInit = this;
+			return *this;
+		}
+	};
+public:
+	SMyStateSwitch();
+
+	SLATE_BEGIN_ARGS(SMyStateSwitch)
+		: _StateIndex(0)
+		, _NumStates(2)
+		, _IsFocusable(true)
+	{
+	}
+	SLATE_SUPPORTS_SLOT(SMyStateSwitch::FSlot)
+	SLATE_ATTRIBUTE(int32, StateIndex)
+	SLATE_ARGUMENT(int32, NumStates)
+	/** Order states are cycled through on click or accept, empty means 0 .. NumStates - 1 */
+	SLATE_ARGUMENT(TArray<int32>, CycleOrder)
+	SLATE_ARGUMENT(bool, IsFocusable)
+	SLATE_ATTRIBUTE(EButtonClickMethod::Type, ClickMethod)
+	SLATE_EVENT(FOnStateSwitchChanged, OnStateChanged)
+	SLATE_END_ARGS()
+
+	void Construct(const FArguments& InArgs);
+
+	static FSlot& Slot()
+	{
+		return *FSwitchChildren::AllocateSlot();
+	}
+
+	FSlot& AddSlot()
+	{
+		Invalidate(EInvalidateWidget::Layout);
+		InvalidateStateBuckets();
+		SMyStateSwitch::FSlot& slot = *this->Children.AllocatePooledSlot();
+		this->Children.Add(&slot);
+		return slot;
+	}
+
+	int32 RemoveSlot(const TSharedRef<SWidget>& SlotWidget);
+	/** Removes a slot by identity, also works for slots showing the shared null widget. */
+	int32 RemoveSlot(const FSlot* SlotToRemove);
+	void ClearChildren();
+
+	void SetStateIndex(TAttribute<int32> InStateIndex);
+	int32 GetStateIndex() const
+	{
+		return StateIndex.Get();
+	}
+
+	void SetNumStates(int32 InNumStates);
+	int32 GetNumStates() const
+	{
+		return NumStates;
+	}
+
+	void SetCycleOrder(const TArray<int32>& InCycleOrder);
+
+	/** The state CycleState would switch to from InStateIndex. */
+	int32 GetNextState(int32 InStateIndex) const;
+
+	/** Advances to the next state of the cycle order and notifies listeners. */
+	void CycleState();
+
+	/** Must be called when a slot's state index or z-order changes. */
+	void InvalidateStateBuckets();
+
+	// Called by UMyStateSwitchSlot when it changes a slot after it was added, like the SMyToggle equivalents.
+
+	/** The slot's z-order changed: rebuilds the state buckets and repaints. */
+	void InvalidateSlotOrder();
+	/** The slot's state index changed: rebuilds the state buckets and re-layouts. */
+	void InvalidateSlotStates();
+	/** The slot's desired size contribution changed, e.g. its anchors or size to content. */
+	void InvalidateSlotDesiredSize(const FSlot& Slot);
+	/** The slot's arranged geometry changed without affecting the switch's desired size, e.g. its alignment. */
+	void InvalidateSlotGeometry(const FSlot& Slot);
+	/** The slot's offset changed: repaint, or re-layout if the desired size is affected. */
+	void InvalidateSlotOffset(const FSlot& Slot, const FMargin& OldOffset);
+
+	/** Whether the slot belongs to the active state. */
+	bool IsSlotShown(const FSlot& Slot) const;
+
+	bool IsPressed() const
+	{
+		return bIsPressed;
+	}
+public:
+	// Begin SWidget overrides
+	virtual void OnArrangeChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren) const override;
+	virtual int32 OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const override;
+	virtual FChildren* GetChildren() override
+	{
+		return &Children;
+	}
+
+	virtual bool SupportsKeyboardFocus() const override;
+	virtual FReply OnKeyUp(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent) override;
+	virtual FReply OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual FReply OnMouseButtonDoubleClick(const FGeometry& InMyGeometry, const FPointerEvent& InMouseEvent) override;
+	virtual FReply OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
+	virtual void OnMouseLeave(const FPointerEvent& MouseEvent) override;
+	virtual bool IsInteractable() const override;
+	// End SWidget overrides
+protected:
+	// Begin SWidget overrides.
+	virtual FVector2D ComputeDesiredSize(float) const override;
+	virtual bool CustomPrepass(float LayoutScaleMultiplier) override;
+	// End SWidget overrides.
+private:
+	/** Layer flags are inline up to a typical child count. Not on the mem stack, OnPaint keeps them across the children's paint. */
+	typedef TArray<bool, TInlineAllocator<32>> FArrangedChildLayers;
+	typedef TArray<int32> FStateBucket;
+
+	void ArrangeLayeredChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren, FArrangedChildLayers& ArrangedChildLayers) const;
+
+	/** Children indices of the active state, sorted by z-order. */
+	const FStateBucket& GetActiveBucket() const;
+	void RebuildStateBuckets() const;
+	void RebuildNextStates();
+protected:
+	typedef TMyTogglePanelChildren<FSlot> FSwitchChildren;
+
+	FSwitchChildren Children;
+
+	TAttribute<int32> StateIndex;
+	int32 NumStates;
+	TArray<int32> CycleOrder;
+
+	FOnStateSwitchChanged OnStateChanged;
+
+	EButtonClickMethod::Type ClickMethod;
+
+	bool bIsFocusable;
+	bool bIsPressed;
+
+private:
+	/** One bucket per state plus a trailing one for out of range states, holding only the all-states slots. */
+	mutable TArray<FStateBucket> StateBuckets;
+	mutable bool bStateBucketsDirty;
+	/** A child's z-order is bound, the buckets are re-sorted on every arrange. */
+	mutable bool bHasBoundZOrder;
+
+	/** Next state for every state, derived from CycleOrder. */
+	TArray<int32> NextStates;
+
+	/**
+	 * Scratch arrangement reused by OnPaint so steady-state frames don't reallocate it. Emptied after every paint but
+	 * keeps its capacity, sized for the biggest state painted so far, for the switch's lifetime.
+	 */
+	mutable FArrangedChildren PaintArrangedChildren;
+};
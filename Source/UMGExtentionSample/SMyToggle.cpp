@@ -1,22 +1,67 @@
 #include "SMyToggle.h"
+#include "MyToggleLayout.h"
 #include "Types/PaintArgs.h"
 #include "Layout/ArrangedChildren.h"
 #include "SlateSettings.h"
 #include "Widgets/SWidget.h"
 #include "Layout/WidgetPath.h"
 #include "Framework/Application/SlateApplication.h"
+#include "MyToggleLatency.h"
+#include "MyToggleFrameStats.h"
+#include "MyToggleInputRecorder.h"
+#include "MyToggleMenuCache.h"
+#include "MyTogglePrefetch.h"
+#include "MyToggleNavigationGrid.h"
+#include "Input/NavigationReply.h"
+
+/** Nesting of toggles inside toggles, only the outermost pass is timed. */
+static int32 GMyToggleArrangeDepth = 0;
+static int32 GMyTogglePaintDepth = 0;
+static int32 GMyToggleDesiredSizeDepth = 0;
+static int32 GMyToggleBroadcastDepth = 0;
 
 
 SMyToggle::SMyToggle()
 	: Children(this)
+	, LastPrefetchedState(ECheckBoxState::Unchecked)
+	, LastPrefetchTime(0.0)
+	, bPrebuildMenuOnHover(false)
+	, PaintArrangedChildren(EVisibility::Visible)
+	, LastPaintFrame(0)
+	, bSlotOrderDirty(true)
+	, bHasBoundZOrder(false)
+	, bSpatialIndexDirty(true)
+	, bSpatialIndexVolatile(false)
+	, SpatialIndexState(ECheckBoxState::Unchecked)
+	, SpatialIndexSize(FVector2D::ZeroVector)
+	, bOptimisticUpdate(false)
+	, OptimisticTimeout(1.0f)
+	, bHasPrediction(false)
+	, PredictedState(ECheckBoxState::Unchecked)
+	, PredictionBaseState(ECheckBoxState::Unchecked)
+	, PredictionSerial(0)
+	, LatencyInputTime(0.0)
+	, LatencyPaintInputTime(0.0)
+	, bLatencyPaintPending(false)
+	, LatencyExpectedState(ECheckBoxState::Unchecked)
 {
 	SetCanTick(false);
 	bCanSupportFocus = true;
+	bHasCustomPrepass = true;
+}
+
+SMyToggle::~SMyToggle()
+{
+	if (NavigationGrid.IsValid())
+	{
+		NavigationGrid->RemoveToggle(*this);
+	}
 }
 
 void SMyToggle::Construct(const SMyToggle::FArguments& InArgs)
 {
 	const int32 NumSlots = InArgs.Slots.Num();
+	Children.Reserve(NumSlots);
 	for (int32 SlotIndex = 0; SlotIndex < NumSlots; ++SlotIndex)
 	{
 		Children.Add(InArgs.Slots[SlotIndex]);
@@ -25,8 +70,14 @@ void SMyToggle::Construct(const SMyToggle::FArguments& InArgs)
 	IsToggleChecked = InArgs._IsToggleChecked;
 	bIsFocusable = InArgs._IsFocusable;
 	OnToggleCheckStateChanged = InArgs._OnToggleCheckStateChanged;
+	OnPrefetchState = InArgs._OnPrefetchState;
 	ClickMethod = InArgs._ClickMethod.Get();
 	OnGetMenuContent = InArgs._OnGetMenuContent;
+	MenuContentKey = InArgs._MenuContentKey;
+	bPrebuildMenuOnHover = InArgs._PrebuildMenuOnHover;
+	SetNavigationGrid(InArgs._NavigationGrid);
+	bOptimisticUpdate = InArgs._OptimisticUpdate;
+	OptimisticTimeout = InArgs._OptimisticTimeout;
 
 	bIsPressed = false;
 
@@ -38,29 +89,91 @@ void SMyToggle::ClearChildren()
 	{
 		Invalidate(EInvalidateWidget::Layout);
 		Children.Empty();
+		bSlotOrderDirty = true;
+		bSpatialIndexDirty = true;
 	}
 }
 
-struct FToggleChildZOrder
-{
-	int32 ChildIndex;
-	float ZOrder;
-};
-
 struct FToggleSortSlotsByZOrder
 {
-	FORCEINLINE bool operator()(const FToggleChildZOrder& A, const FToggleChildZOrder& B) const
+	FORCEINLINE bool operator()(const SMyToggle::FChildZOrder& A, const SMyToggle::FChildZOrder& B) const
 	{
 		return A.ZOrder == B.ZOrder ? A.ChildIndex < B.ChildIndex : A.ZOrder < B.ZOrder;
 	}
 };
 
-bool SMyToggle::IsSameWithCheckState(const EToggleSlotType& SlotType) const
+bool SMyToggle::IsSameWithCheckState(const FSlot& Slot) const
+{
+	return (Slot.GetStateMask() & ToggleStateToMask((uint8)GetCheckedState())) != 0;
+}
+
+void SMyToggle::RebuildSlotOrder() const
+{
+	bSlotOrderDirty = false;
+	bHasBoundZOrder = false;
+
+	// Sorted over all children, so switching state doesn't need a new sort.
+	CachedSlotOrder.Reset(Children.Num());
+	for (int32 ChildIndex = 0; ChildIndex < Children.Num(); ++ChildIndex)
+	{
+		const SMyToggle::FSlot& CurChild = Children[ChildIndex];
+
+		FChildZOrder Order;
+		Order.ChildIndex = ChildIndex;
+		Order.ZOrder = CurChild.ZOrderAttr.Get();
+		CachedSlotOrder.Add(Order);
+
+		bHasBoundZOrder |= CurChild.ZOrderAttr.IsBound();
+	}
+
+	CachedSlotOrder.Sort(FToggleSortSlotsByZOrder());
+}
+
+void SMyToggle::InvalidateSlotOrder()
 {
-	if (EToggleSlotType::Other == SlotType)
-		return true;
+	bSlotOrderDirty = true;
+	bSpatialIndexDirty = true;
+	Invalidate(EInvalidateWidget::Paint);
+}
 
-	return (uint8)SlotType == (uint8)IsToggleChecked.Get();
+void SMyToggle::InvalidateSlotStates(const FSlot& Slot, uint8 OldStateMask)
+{
+	// Only matters when the slot appears in or disappears from the state we are showing.
+	bSpatialIndexDirty = true;
+	const uint8 StateBit = ToggleStateToMask((uint8)GetCheckedState());
+	if ((OldStateMask & StateBit) != (Slot.GetStateMask() & StateBit))
+	{
+		Invalidate(EInvalidateWidget::Layout);
+	}
+}
+
+void SMyToggle::InvalidateSlotDesiredSize(const FSlot& Slot)
+{
+	bSpatialIndexDirty = true;
+	if (IsSameWithCheckState(Slot))
+	{
+		Invalidate(EInvalidateWidget::Layout);
+	}
+}
+
+void SMyToggle::InvalidateSlotGeometry(const FSlot& Slot)
+{
+	bSpatialIndexDirty = true;
+	if (IsSameWithCheckState(Slot))
+	{
+		Invalidate(EInvalidateWidget::Paint);
+	}
+}
+
+void SMyToggle::InvalidateSlotOffset(const FSlot& Slot, const FMargin& OldOffset)
+{
+	bSpatialIndexDirty = true;
+	if (!IsSameWithCheckState(Slot))
+		return;
+
+	// A move only re-lays the toggle out when it changes the slot's contribution to the desired size,
+	// see MyToggleLayout::AccumulateDesiredSize. Otherwise the child is just arranged somewhere else on paint.
+	Invalidate(MyToggleLayout::DoesOffsetChangeDesiredSize(Slot, OldOffset) ? EInvalidateWidget::Layout : EInvalidateWidget::Paint);
 }
 
 void SMyToggle::ArrangeLayeredChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren, FArrangedChildLayers& ArrangedChildLayers) const
@@ -68,83 +181,51 @@ void SMyToggle::ArrangeLayeredChildren(const FGeometry& AllottedGeometry, FArran
 	if (Children.Num() <= 0)
 		return;
 
+	FMyToggleFrameStats& FrameStats = FMyToggleFrameStats::Current();
+	FMyToggleScopedFrameTimer ArrangeTimer(FrameStats.ArrangeMs, GMyToggleArrangeDepth);
+	const int32 NumArrangedBefore = ArrangedChildren.Num();
+
 #if WITH_EDITOR
 	const bool bExplicitChildZOrder = GetDefault<USlateSettings>()->bExplicitCanvasChildZOrder;
 #else
 	const static bool bExplicitChildZOrder = GetDefault<USlateSettings>()->bExplicitCanvasChildZOrder;
 #endif
 
-	TArray< FToggleChildZOrder, TInlineAllocator<64> > SlotOrder;
-	SlotOrder.Reserve(Children.Num());
-
-	for (int32 ChildIndex = 0; ChildIndex < Children.Num(); ++ChildIndex)
+	if (bSlotOrderDirty || bHasBoundZOrder)
 	{
-		const SMyToggle::FSlot& CurChild = Children[ChildIndex];
-		if (IsSameWithCheckState(CurChild.SlotTypeAttr.Get()))
-		{
-			FToggleChildZOrder Order;
-			Order.ChildIndex = ChildIndex;
-			Order.ZOrder = CurChild.ZOrderAttr.Get();
-			SlotOrder.Add(Order);
-		}
+		RebuildSlotOrder();
 	}
 
-	SlotOrder.Sort(FToggleSortSlotsByZOrder());
+	const TArray<FChildZOrder>& SlotOrder = CachedSlotOrder;
 	float LastZOrder = -FLT_MAX;
 
+	// Detail below the slots' minimum draw size is dropped. The desired size still counts those slots,
+	// so a toggle that shrinks past a threshold doesn't change its layout.
+	const FVector2D AbsoluteSize = AllottedGeometry.GetAbsoluteSize();
+	const float DrawSize = FMath::Min(AbsoluteSize.X, AbsoluteSize.Y);
+	int32 NumSkippedBySize = 0;
+
 	for (int32 ChildIndex = 0; ChildIndex < SlotOrder.Num(); ++ChildIndex)
 	{
-		const FToggleChildZOrder& CurSlotZOrder = SlotOrder[ChildIndex];
+		const FChildZOrder& CurSlotZOrder = SlotOrder[ChildIndex];
 		const SMyToggle::FSlot& CurSlot = Children[CurSlotZOrder.ChildIndex];
-		const TSharedRef<SWidget>& CurWidget = CurSlot.GetWidget();
-
-		const EVisibility ChildVisibility = CurWidget->GetVisibility();
-		if (!ArrangedChildren.Accepts(ChildVisibility))
-			continue;
 
-		if (!IsSameWithCheckState(CurSlot.SlotTypeAttr.Get()))
+		if (!IsSameWithCheckState(CurSlot))
 			continue;
 
-		const FMargin& Offset = CurSlot.OffsetAttr.Get();
-		const FVector2D& Alignment = CurSlot.AlignmentAttr.Get();
-		const FAnchors& Anchors = CurSlot.AnchorsAttr.Get();
-		const bool AutoSize = CurSlot.AutoSizeAttr.Get();
-
-		const FVector2D& LocalSizeGeometry = AllottedGeometry.GetLocalSize();
-		const FMargin AnchorPixels = FMargin(
-			Anchors.Minimum.X * LocalSizeGeometry.X,
-			Anchors.Minimum.Y * LocalSizeGeometry.Y,
-			Anchors.Maximum.X * LocalSizeGeometry.X,
-			Anchors.Maximum.Y * LocalSizeGeometry.Y);
-
-		bool bIsHorizontalStretch = Anchors.Minimum.X != Anchors.Maximum.X;
-		bool bIsVerticalStretch = Anchors.Minimum.Y != Anchors.Maximum.Y;
-		FVector2D SlotSize(Offset.Right, Offset.Bottom);
-		FVector2D Size = AutoSize ? CurWidget->GetDesiredSize() : SlotSize;
-		FVector2D AlignmentOffset = Size * Alignment;
-		FVector2D LocalPosition, LocalSize;
-
-		if (bIsHorizontalStretch)
-		{
-			LocalPosition.X = AnchorPixels.Left + Offset.Left;
-			LocalSize.X = AnchorPixels.Right - LocalPosition.X - Offset.Right;
-		}
-		else
+		if (DrawSize < CurSlot.MinDrawSizeAttr.Get())
 		{
-			LocalPosition.X = AnchorPixels.Left + Offset.Left - AlignmentOffset.X;
-			LocalSize.X = Size.X;
+			++NumSkippedBySize;
+			continue;
 		}
 
-		if (bIsVerticalStretch)
-		{
-			LocalPosition.Y = AnchorPixels.Top + Offset.Top;
-			LocalSize.Y = AnchorPixels.Bottom - LocalPosition.Y - Offset.Bottom;
-		}
-		else
-		{
-			LocalPosition.Y = AnchorPixels.Top + Offset.Top - AlignmentOffset.Y;
-			LocalSize.Y = Size.Y;
-		}
+		const TSharedRef<SWidget>& CurWidget = CurSlot.GetWidget();
+		const EVisibility ChildVisibility = CurWidget->GetVisibility();
+		if (!ArrangedChildren.Accepts(ChildVisibility))
+			continue;
+
+		FVector2D LocalPosition, LocalSize;
+		MyToggleLayout::ArrangeSlot(AllottedGeometry.GetLocalSize(), CurSlot, LocalPosition, LocalSize);
 
 		ArrangedChildren.AddWidget(ChildVisibility,
 			AllottedGeometry.MakeChild(CurWidget, LocalPosition, LocalSize));
@@ -166,6 +247,102 @@ void SMyToggle::ArrangeLayeredChildren(const FGeometry& AllottedGeometry, FArran
 		ArrangedChildLayers.Add(bNewLayer);
 	}
 
+	FrameStats.NumChildrenArranged += ArrangedChildren.Num() - NumArrangedBefore;
+	FrameStats.NumChildrenBelowDrawSize += NumSkippedBySize;
+}
+
+void SMyToggle::UpdateSpatialIndex(const FGeometry& AllottedGeometry) const
+{
+	const ECheckBoxState State = GetCheckedState();
+	const FVector2D LocalSize = AllottedGeometry.GetLocalSize();
+	if (!bSpatialIndexDirty && !bSpatialIndexVolatile && SpatialIndexState == State && SpatialIndexSize == LocalSize)
+		return;
+
+	bSpatialIndexDirty = false;
+	bSpatialIndexVolatile = false;
+	SpatialIndexState = State;
+	SpatialIndexSize = LocalSize;
+
+	if (bSlotOrderDirty || bHasBoundZOrder)
+	{
+		RebuildSlotOrder();
+	}
+	bSpatialIndexVolatile = bHasBoundZOrder;
+
+	TArray<FMyToggleSpatialIndex::FEntry> Entries;
+	Entries.Reserve(CachedSlotOrder.Num());
+	for (int32 OrderIndex = 0; OrderIndex < CachedSlotOrder.Num(); ++OrderIndex)
+	{
+		const int32 ChildIndex = CachedSlotOrder[OrderIndex].ChildIndex;
+		const SMyToggle::FSlot& CurSlot = Children[ChildIndex];
+		if (!IsSameWithCheckState(CurSlot))
+			continue;
+
+		// Size to content follows the child's desired size, which changes without telling us.
+		bSpatialIndexVolatile |= CurSlot.AutoSizeAttr.Get() || CurSlot.AutoSizeAttr.IsBound()
+			|| CurSlot.OffsetAttr.IsBound() || CurSlot.AnchorsAttr.IsBound() || CurSlot.AlignmentAttr.IsBound();
+
+		FVector2D LocalPosition, LocalChildSize;
+		MyToggleLayout::ArrangeSlot(LocalSize, CurSlot, LocalPosition, LocalChildSize);
+
+		FMyToggleSpatialIndex::FEntry Entry;
+		Entry.ChildIndex = ChildIndex;
+		Entry.PaintOrder = OrderIndex;
+		Entry.Rect = FSlateRect(LocalPosition, LocalPosition + LocalChildSize);
+		Entries.Add(Entry);
+	}
+
+	SpatialIndex.Build(Entries, Children.Num());
+}
+
+void SMyToggle::FindChildrenAtPosition(const FGeometry& AllottedGeometry, const FVector2D& AbsolutePosition, TArray<int32>& OutChildIndices) const
+{
+	UpdateSpatialIndex(AllottedGeometry);
+
+	TArray<const FMyToggleSpatialIndex::FEntry*> Hits;
+	SpatialIndex.QueryPoint(AllottedGeometry.AbsoluteToLocal(AbsolutePosition), Hits);
+	Hits.Sort([](const FMyToggleSpatialIndex::FEntry& A, const FMyToggleSpatialIndex::FEntry& B) { return A.PaintOrder > B.PaintOrder; });
+
+	// Visibility and the minimum draw size aren't part of the index, they are checked on the few hits.
+	const FVector2D AbsoluteSize = AllottedGeometry.GetAbsoluteSize();
+	const float DrawSize = FMath::Min(AbsoluteSize.X, AbsoluteSize.Y);
+	for (const FMyToggleSpatialIndex::FEntry* Hit : Hits)
+	{
+		const SMyToggle::FSlot& CurSlot = Children[Hit->ChildIndex];
+		if (DrawSize >= CurSlot.MinDrawSizeAttr.Get() && CurSlot.GetWidget()->GetVisibility().IsVisible())
+		{
+			OutChildIndices.Add(Hit->ChildIndex);
+		}
+	}
+}
+
+bool SMyToggle::FindChildGeometry(const FGeometry& AllottedGeometry, const FSlot& Slot, FGeometry& OutGeometry) const
+{
+	const int32* ChildIndexPtr = ChildIndexBySlot.Find(&Slot);
+	if (ChildIndexPtr == nullptr || *ChildIndexPtr >= Children.Num() || &Children[*ChildIndexPtr] != &Slot)
+	{
+		// Children were added or removed since the last lookup.
+		ChildIndexBySlot.Reset();
+		for (int32 ChildIndex = 0; ChildIndex < Children.Num(); ++ChildIndex)
+		{
+			ChildIndexBySlot.Add(&Children[ChildIndex], ChildIndex);
+		}
+
+		ChildIndexPtr = ChildIndexBySlot.Find(&Slot);
+		if (ChildIndexPtr == nullptr)
+			return false;
+	}
+	const int32 ChildIndex = *ChildIndexPtr;
+
+	UpdateSpatialIndex(AllottedGeometry);
+
+	const FMyToggleSpatialIndex::FEntry* Entry = SpatialIndex.FindChild(ChildIndex);
+	const FVector2D AbsoluteSize = AllottedGeometry.GetAbsoluteSize();
+	if (Entry == nullptr || FMath::Min(AbsoluteSize.X, AbsoluteSize.Y) < Slot.MinDrawSizeAttr.Get())
+		return false;
+
+	OutGeometry = AllottedGeometry.MakeChild(Slot.GetWidget(), Entry->Rect.GetTopLeft(), Entry->Rect.GetSize()).Geometry;
+	return true;
 }
 
 void SMyToggle::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren) const
@@ -177,8 +354,24 @@ void SMyToggle::OnArrangeChildren(const FGeometry& AllottedGeometry, FArrangedCh
 int32 SMyToggle::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeometry, const FSlateRect& MyCullingRect, FSlateWindowElementList& OutDrawElements, int32 LayerId, const FWidgetStyle& InWidgetStyle, bool bParentEnabled) const
 {
 	SCOPED_NAMED_EVENT_TEXT("SMyToggle", FColor::Cyan);
+	LastPaintFrame = GFrameCounter;
+
+	if (bLatencyPaintPending)
+	{
+		FinishLatencyPaint();
+	}
+
+	if (NavigationGrid.IsValid())
+	{
+		NavigationGrid->UpdateGeometry(*this, AllottedGeometry);
+	}
+
+	FMyToggleFrameStats& FrameStats = FMyToggleFrameStats::Current();
+	FMyToggleScopedFrameTimer PaintTimer(FrameStats.PaintMs, GMyTogglePaintDepth);
+	++FrameStats.NumActiveToggles;
 	FArrangedChildLayers ChildLayers;
-	FArrangedChildren ArrangedChildren(EVisibility::Visible);
+	FArrangedChildren& ArrangedChildren = PaintArrangedChildren;
+	ArrangedChildren.GetInternalArray().Reset();
 	ArrangeLayeredChildren(AllottedGeometry, ArrangedChildren, ChildLayers);
 	const bool bForwardedEnabled = ShouldBeEnabled(bParentEnabled);
 
@@ -192,19 +385,28 @@ int32 SMyToggle::OnPaint(const FPaintArgs& Args, const FGeometry& AllottedGeomet
 		FArrangedWidget& CurWidget = ArrangedChildren[ChildIndex];
 		if (!IsChildWidgetCulled(MyCullingRect, CurWidget))
 		{
+			FrameStats.NumLayers += ChildLayers[ChildIndex] ? 1 : 0;
 			ChildLayerId = ChildLayers[ChildIndex] ? MaxLayerId + 1 : ChildLayerId;
 			const int32 CurWidgetsMaxLayerId = CurWidget.Widget->Paint(NewArgs,
 				CurWidget.Geometry, MyCullingRect, OutDrawElements,
 				ChildLayerId, InWidgetStyle, bForwardedEnabled);
 			MaxLayerId = FMath::Max(MaxLayerId, CurWidgetsMaxLayerId);
 		}
+		else
+		{
+			++FrameStats.NumChildrenCulled;
+		}
 	}
 
+	// Keep the capacity for the next frame but don't hold on to the child widgets.
+	ArrangedChildren.GetInternalArray().Reset();
+
 	return MaxLayerId;
 }
 
 FVector2D SMyToggle::ComputeDesiredSize(float) const
 {
+	FMyToggleScopedFrameTimer DesiredSizeTimer(FMyToggleFrameStats::Current().DesiredSizeMs, GMyToggleDesiredSizeDepth);
 	FVector2D FinalDesiredSize(0, 0);
 
 	// Arrange the children now in their proper z-order.
@@ -215,32 +417,50 @@ FVector2D SMyToggle::ComputeDesiredSize(float) const
 		const EVisibility ChildVisibilty = Widget->GetVisibility();
 
 		// As long as the widgets are not collapsed, they should contribute to the desired size.
-		if (ChildVisibilty != EVisibility::Collapsed && IsSameWithCheckState(CurChild.SlotTypeAttr.Get()))
+		if (ChildVisibilty != EVisibility::Collapsed && IsSameWithCheckState(CurChild))
 		{
-			const FMargin Offset = CurChild.OffsetAttr.Get();
-			const FVector2D Alignment = CurChild.AlignmentAttr.Get();
-			const FAnchors Anchors = CurChild.AnchorsAttr.Get();
-
-			const FVector2D SlotSize = FVector2D(Offset.Right, Offset.Bottom);
-
-			const bool AutoSize = CurChild.AutoSizeAttr.Get();
+			MyToggleLayout::AccumulateDesiredSize(CurChild, FinalDesiredSize);
+		}
+	}
 
-			const FVector2D Size = AutoSize ? Widget->GetDesiredSize() : SlotSize;
+	return FinalDesiredSize;
+}
 
-			const bool bIsDockedHorizontally = (Anchors.Minimum.X == Anchors.Maximum.X) && (Anchors.Minimum.X == 0 || Anchors.Minimum.X == 1);
-			const bool bIsDockedVertically = (Anchors.Minimum.Y == Anchors.Maximum.Y) && (Anchors.Minimum.Y == 0 || Anchors.Minimum.Y == 1);
+bool SMyToggle::CustomPrepass(float LayoutScaleMultiplier)
+{
+	// Children of the states we are not showing are never arranged or painted, so don't pay for their prepass.
+	// They get prepassed on the first layout after the state switches to them.
+	for (int32 ChildIndex = 0; ChildIndex < Children.Num(); ++ChildIndex)
+	{
+		const SMyToggle::FSlot& CurChild = Children[ChildIndex];
+		if (!IsSameWithCheckState(CurChild))
+			continue;
 
-			FinalDesiredSize.X = FMath::Max(FinalDesiredSize.X, Size.X + (bIsDockedHorizontally ? FMath::Abs(Offset.Left) : 0.0f));
-			FinalDesiredSize.Y = FMath::Max(FinalDesiredSize.Y, Size.Y + (bIsDockedVertically ? FMath::Abs(Offset.Top) : 0.0f));
+		const TSharedRef<SWidget>& Widget = CurChild.GetWidget();
+		if (Widget->GetVisibility() != EVisibility::Collapsed)
+		{
+			Widget->SlatePrepass(LayoutScaleMultiplier);
 		}
 	}
 
-	return FinalDesiredSize;
+	// We handled the children ourselves.
+	return false;
 }
 
 void SMyToggle::SetToggleIsChecked(TAttribute<ECheckBoxState> InIsToggleChecked)
 {
+	const ECheckBoxState OldState = GetCheckedState();
 	IsToggleChecked = InIsToggleChecked;
+	bHasPrediction = false;
+
+	// Models push their value on every sync, only a different state is a transition.
+	if (IsToggleChecked.Get() != OldState)
+	{
+		++FMyToggleFrameStats::Current().NumStateTransitions;
+	}
+
+	// A different set of children is now active, their desired sizes have to be refreshed.
+	Invalidate(EInvalidateWidget::Layout);
 }
 
 int32 SMyToggle::RemoveSlot(const TSharedRef<SWidget>& SlotWidget)
@@ -251,6 +471,25 @@ int32 SMyToggle::RemoveSlot(const TSharedRef<SWidget>& SlotWidget)
 		if (SlotWidget == Children[SlotIdx].GetWidget())
 		{
 			Children.RemoveAt(SlotIdx);
+			bSlotOrderDirty = true;
+			bSpatialIndexDirty = true;
+			return SlotIdx;
+		}
+	}
+
+	return -1;
+}
+
+int32 SMyToggle::RemoveSlot(const FSlot* SlotToRemove)
+{
+	for (int32 SlotIdx = 0; SlotIdx < Children.Num(); ++SlotIdx)
+	{
+		if (&Children[SlotIdx] == SlotToRemove)
+		{
+			Invalidate(EInvalidateWidget::Layout);
+			Children.RemoveAt(SlotIdx);
+			bSlotOrderDirty = true;
+			bSpatialIndexDirty = true;
 			return SlotIdx;
 		}
 	}
@@ -258,6 +497,25 @@ int32 SMyToggle::RemoveSlot(const TSharedRef<SWidget>& SlotWidget)
 	return -1;
 }
 
+SIZE_T SMyToggle::GetSlotStorageSize() const
+{
+	SIZE_T Size = Children.GetAllocatedSize() + CachedSlotOrder.GetAllocatedSize() + SpatialIndex.GetAllocatedSize()
+		+ ChildIndexBySlot.GetAllocatedSize() + PaintArrangedChildren.GetInternalArray().GetAllocatedSize();
+	for (int32 SlotIndex = 0; SlotIndex < Children.Num(); ++SlotIndex)
+	{
+		const FSlot& CurSlot = Children[SlotIndex];
+		Size += CurSlot.OffsetAttr.GetBinding().GetAllocatedSize()
+			+ CurSlot.AnchorsAttr.GetBinding().GetAllocatedSize()
+			+ CurSlot.AlignmentAttr.GetBinding().GetAllocatedSize()
+			+ CurSlot.AutoSizeAttr.GetBinding().GetAllocatedSize()
+			+ CurSlot.ZOrderAttr.GetBinding().GetAllocatedSize()
+			+ CurSlot.SlotTypeAttr.GetBinding().GetAllocatedSize()
+			+ CurSlot.StateMaskAttr.GetBinding().GetAllocatedSize()
+			+ CurSlot.MinDrawSizeAttr.GetBinding().GetAllocatedSize();
+	}
+	return Size;
+}
+
 bool SMyToggle::SupportsKeyboardFocus() const
 {
 	return bIsFocusable;
@@ -265,10 +523,16 @@ bool SMyToggle::SupportsKeyboardFocus() const
 
 FReply SMyToggle::OnKeyUp(const FGeometry& MyGeometry, const FKeyEvent& InKeyEvent)
 {
+	if (FMyToggleInputRecorder::IsRecording())
+	{
+		FMyToggleInputRecorder::Get().Record(*this, EMyToggleInputEvent::KeyUp, MyGeometry, MyGeometry.GetAbsolutePosition(), InKeyEvent.GetKey());
+	}
+
 	if (InKeyEvent.GetKey() == EKeys::Enter 
 		|| InKeyEvent.GetKey() == EKeys::SpaceBar 
 		|| InKeyEvent.GetKey() == EKeys::Virtual_Accept)
 	{
+		BeginLatencySample();
 		ToggleCheckedState();
 		return FReply::Handled();
 	}
@@ -277,6 +541,16 @@ FReply SMyToggle::OnKeyUp(const FGeometry& MyGeometry, const FKeyEvent& InKeyEve
 }
 
 FReply SMyToggle::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
+{
+	if (FMyToggleInputRecorder::IsRecording())
+	{
+		FMyToggleInputRecorder::Get().Record(*this, EMyToggleInputEvent::MouseDown, MyGeometry, MouseEvent.GetScreenSpacePosition(), MouseEvent.GetEffectingButton());
+	}
+
+	return HandleMouseButtonDown(MyGeometry, MouseEvent);
+}
+
+FReply SMyToggle::HandleMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
 	if (MouseEvent.GetEffectingButton() == EKeys::LeftMouseButton)
 	{
@@ -284,6 +558,7 @@ FReply SMyToggle::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerE
 
 		if (ClickMethod == EButtonClickMethod::MouseDown)
 		{
+			BeginLatencySample();
 			ToggleCheckedState();
 
 			// Set focus to this button, but don't capture the mouse
@@ -302,7 +577,7 @@ FReply SMyToggle::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerE
 		FSlateApplication::Get().PushMenu(
 			AsShared(),
 			WidgetPath,
-			OnGetMenuContent.Execute(),
+			MenuContentKey != NAME_None ? FMyToggleMenuCache::Get().GetOrBuild(MenuContentKey, OnGetMenuContent) : OnGetMenuContent.Execute(),
 			MouseEvent.GetScreenSpacePosition(),
 			FPopupTransitionEffect(FPopupTransitionEffect::ContextMenu)
 		);
@@ -317,11 +592,21 @@ FReply SMyToggle::OnMouseButtonDown(const FGeometry& MyGeometry, const FPointerE
 
 FReply SMyToggle::OnMouseButtonDoubleClick(const FGeometry& InMyGeometry, const FPointerEvent& InMouseEvent)
 {
-	return OnMouseButtonDown(InMyGeometry, InMouseEvent);
+	if (FMyToggleInputRecorder::IsRecording())
+	{
+		FMyToggleInputRecorder::Get().Record(*this, EMyToggleInputEvent::DoubleClick, InMyGeometry, InMouseEvent.GetScreenSpacePosition(), InMouseEvent.GetEffectingButton());
+	}
+
+	return HandleMouseButtonDown(InMyGeometry, InMouseEvent);
 }
 
 FReply SMyToggle::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
+	if (FMyToggleInputRecorder::IsRecording())
+	{
+		FMyToggleInputRecorder::Get().Record(*this, EMyToggleInputEvent::MouseUp, MyGeometry, MouseEvent.GetScreenSpacePosition(), MouseEvent.GetEffectingButton());
+	}
+
 	if (MouseEvent.GetEffectingButton() == EKeys::LeftMouseButton)
 	{
 		bIsPressed = false;
@@ -341,6 +626,7 @@ FReply SMyToggle::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEve
 				// pressed the button down first, then we'll allow the click to proceed without an active capture
 				if (ClickMethod == EButtonClickMethod::MouseUp || HasMouseCapture())
 				{
+					BeginLatencySample();
 					ToggleCheckedState();
 				}
 			}
@@ -354,11 +640,28 @@ FReply SMyToggle::OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEve
 
 void SMyToggle::OnMouseEnter(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent)
 {
+	if (FMyToggleInputRecorder::IsRecording())
+	{
+		FMyToggleInputRecorder::Get().Record(*this, EMyToggleInputEvent::MouseEnter, MyGeometry, MouseEvent.GetScreenSpacePosition(), MouseEvent.GetEffectingButton());
+	}
+
 	SWidget::OnMouseEnter(MyGeometry, MouseEvent);
+
+	PrefetchNextState();
+
+	if (bPrebuildMenuOnHover && MenuContentKey != NAME_None && OnGetMenuContent.IsBound())
+	{
+		FMyToggleMenuCache::Get().RequestPrebuild(MenuContentKey, OnGetMenuContent);
+	}
 }
 
 void SMyToggle::OnMouseLeave(const FPointerEvent& MouseEvent)
 {
+	if (FMyToggleInputRecorder::IsRecording())
+	{
+		FMyToggleInputRecorder::Get().Record(*this, EMyToggleInputEvent::MouseLeave, GetCachedGeometry(), MouseEvent.GetScreenSpacePosition(), MouseEvent.GetEffectingButton());
+	}
+
 	SWidget::OnMouseLeave(MouseEvent);
 
 	// If we're setup to click on mouse-down, then we never capture the mouse and may not receive a
@@ -369,6 +672,79 @@ void SMyToggle::OnMouseLeave(const FPointerEvent& MouseEvent)
 	}
 }
 
+FReply SMyToggle::OnFocusReceived(const FGeometry& MyGeometry, const FFocusEvent& InFocusEvent)
+{
+	PrefetchNextState();
+
+	return SPanel::OnFocusReceived(MyGeometry, InFocusEvent);
+}
+
+FNavigationReply SMyToggle::OnNavigation(const FGeometry& MyGeometry, const FNavigationEvent& InNavigationEvent)
+{
+	if (NavigationGrid.IsValid())
+	{
+		TSharedPtr<SWidget> Neighbour = NavigationGrid->FindNeighbour(*this, InNavigationEvent.GetNavigationType());
+		if (Neighbour.IsValid())
+		{
+			return FNavigationReply::Explicit(Neighbour);
+		}
+	}
+
+	// Off the edge of the grid, or not in one: let Slate find the next widget.
+	return SPanel::OnNavigation(MyGeometry, InNavigationEvent);
+}
+
+void SMyToggle::SetNavigationGrid(const TSharedPtr<FMyToggleNavigationGrid>& InNavigationGrid)
+{
+	if (NavigationGrid == InNavigationGrid)
+		return;
+
+	if (NavigationGrid.IsValid())
+	{
+		NavigationGrid->RemoveToggle(*this);
+	}
+
+	NavigationGrid = InNavigationGrid;
+	if (NavigationGrid.IsValid())
+	{
+		NavigationGrid->AddToggle(*this);
+		Invalidate(EInvalidateWidget::Paint);
+	}
+}
+
+void SMyToggle::PrefetchNextState()
+{
+	if (!OnPrefetchState.IsBound())
+		return;
+
+	const ECheckBoxState NextState = GetNextCheckedState();
+	const double Now = FPlatformTime::Seconds();
+	if (NextState == LastPrefetchedState && LastPrefetchTime > 0.0 && Now - LastPrefetchTime < MyTogglePrefetch::GetResidentSeconds() * 0.5)
+		return;
+
+	LastPrefetchedState = NextState;
+	LastPrefetchTime = Now;
+
+	OnPrefetchState.Execute(NextState);
+
+	// Measuring the children loads their fonts and settles their desired sizes now rather than on the click.
+	const uint8 CurrentStateBit = ToggleStateToMask((uint8)GetCheckedState());
+	const uint8 NextStateBit = ToggleStateToMask((uint8)NextState);
+	for (int32 ChildIndex = 0; ChildIndex < Children.Num(); ++ChildIndex)
+	{
+		const SMyToggle::FSlot& CurChild = Children[ChildIndex];
+		const uint8 StateMask = CurChild.GetStateMask();
+		if ((StateMask & NextStateBit) == 0 || (StateMask & CurrentStateBit) != 0)
+			continue;
+
+		const TSharedRef<SWidget>& Widget = CurChild.GetWidget();
+		if (Widget->GetVisibility() != EVisibility::Collapsed)
+		{
+			Widget->SlatePrepass(GetPrepassLayoutScaleMultiplier());
+		}
+	}
+}
+
 bool SMyToggle::IsInteractable() const
 {
 	return IsEnabled();
@@ -376,29 +752,118 @@ bool SMyToggle::IsInteractable() const
 
 void SMyToggle::ToggleCheckedState()
 {
-	const ECheckBoxState State = IsToggleChecked.Get();
+	FMyToggleFrameStats& FrameStats = FMyToggleFrameStats::Current();
+	FMyToggleScopedFrameTimer BroadcastTimer(FrameStats.BroadcastMs, GMyToggleBroadcastDepth);
+
+	const ECheckBoxState NewState = GetNextCheckedState();
+
+	ShowNewCheckedState(NewState);
+
+	// The state of the check box changed.  Execute the delegate to notify users
+	OnToggleCheckStateChanged.ExecuteIfBound(NewState);
+
+	++FrameStats.NumStateTransitions;
+	FrameStats.NumBroadcasts += OnToggleCheckStateChanged.IsBound() ? 1 : 0;
+
+	if (LatencyInputTime > 0.0)
+	{
+		FinishLatencyBroadcast(NewState);
+	}
+}
 
-	// If the current check box state is checked OR undetermined we set the check box to checked.
-	if (State == ECheckBoxState::Checked || State == ECheckBoxState::Undetermined)
+void SMyToggle::ShowNewCheckedState(ECheckBoxState NewState)
+{
+	if (!IsToggleChecked.IsBound())
 	{
-		if (!IsToggleChecked.IsBound())
+		// When we are not bound, just toggle the current state.
+		IsToggleChecked.Set(NewState);
+	}
+	else if (bOptimisticUpdate)
+	{
+		// Show the state we expect the binding to report, until it reports something else or we give up on it.
+		PredictionBaseState = IsToggleChecked.Get();
+		PredictedState = NewState;
+		bHasPrediction = true;
+		++PredictionSerial;
+
+		TSharedPtr<FActiveTimerHandle> OldTimer = PredictionTimer.Pin();
+		if (OldTimer.IsValid())
 		{
-			// When we are not bound, just toggle the current state.
-			IsToggleChecked.Set(ECheckBoxState::Unchecked);
+			UnRegisterActiveTimer(OldTimer.ToSharedRef());
 		}
-
-		// The state of the check box changed.  Execute the delegate to notify users
-		OnToggleCheckStateChanged.ExecuteIfBound(ECheckBoxState::Unchecked);
+		PredictionTimer = RegisterActiveTimer(OptimisticTimeout,
+			FWidgetActiveTimerDelegate::CreateSP(this, &SMyToggle::HandlePredictionTimeout, PredictionSerial));
+	}
+	else
+	{
+		return;
 	}
-	else if (State == ECheckBoxState::Unchecked)
+
+	Invalidate(EInvalidateWidget::Layout);
+}
+
+ECheckBoxState SMyToggle::GetNextCheckedState() const
+{
+	// If the current check box state is checked OR undetermined we set the check box to unchecked.
+	const ECheckBoxState State = GetCheckedState();
+	return State == ECheckBoxState::Unchecked ? ECheckBoxState::Checked : ECheckBoxState::Unchecked;
+}
+
+ECheckBoxState SMyToggle::GetCheckedState() const
+{
+	const ECheckBoxState BoundState = IsToggleChecked.Get();
+	if (bHasPrediction)
 	{
-		if (!IsToggleChecked.IsBound())
+		// Any change of the bound value is its answer to the click, right or wrong it wins over the prediction.
+		if (BoundState == PredictionBaseState)
 		{
-			// When we are not bound, just toggle the current state.
-			IsToggleChecked.Set(ECheckBoxState::Checked);
+			return PredictedState;
 		}
+		bHasPrediction = false;
+	}
+
+	return BoundState;
+}
 
-		// The state of the check box changed.  Execute the delegate to notify users
-		OnToggleCheckStateChanged.ExecuteIfBound(ECheckBoxState::Checked);
+EActiveTimerReturnType SMyToggle::HandlePredictionTimeout(double InCurrentTime, float InDeltaTime, uint32 InPredictionSerial)
+{
+	if (bHasPrediction && InPredictionSerial == PredictionSerial)
+	{
+		// The binding never confirmed the click, roll back to what it reports.
+		bHasPrediction = false;
+		Invalidate(EInvalidateWidget::Layout);
 	}
-}
\ No newline at end of file
+
+	return EActiveTimerReturnType::Stop;
+}
+
+void SMyToggle::BeginLatencySample()
+{
+	LatencyInputTime = FMyToggleLatencyTracker::IsEnabled() ? FPlatformTime::Seconds() : 0.0;
+}
+
+void SMyToggle::FinishLatencyBroadcast(ECheckBoxState NewState)
+{
+	FMyToggleLatencyTracker::Get().RecordBroadcast(*this, LatencyInputTime, FPlatformTime::Seconds());
+
+	// Bound toggles may show the new state frames later, the paint that first does closes the sample.
+	LatencyPaintInputTime = LatencyInputTime;
+	LatencyInputTime = 0.0;
+	LatencyExpectedState = NewState;
+	bLatencyPaintPending = true;
+}
+
+void SMyToggle::FinishLatencyPaint() const
+{
+	const double PaintTime = FPlatformTime::Seconds();
+	if (GetCheckedState() == LatencyExpectedState)
+	{
+		FMyToggleLatencyTracker::Get().RecordPaint(*this, LatencyPaintInputTime, PaintTime);
+		bLatencyPaintPending = false;
+	}
+	else if (PaintTime - LatencyPaintInputTime > FMyToggleLatencyTracker::GetPaintTimeout())
+	{
+		// The binding rejected the click, there is nothing to measure.
+		bLatencyPaintPending = false;
+	}
+}
@@ -18,12 +18,17 @@
 #include "UMGExtensionDefine.h"
 #include "Input/Reply.h"
 #include "Framework/SlateDelegates.h"
+#include "Layout/ArrangedChildren.h"
+#include "MyToggleSlotPool.h"
+#include "MyToggleSpatialIndex.h"
 
+class FMyToggleNavigationGrid;
 struct FGeometry;
 struct FPointerEvent;
 struct FKeyEvent;
 
 DECLARE_DELEGATE_OneParam(FOnToggleCheckStateChanged, ECheckBoxState);
+DECLARE_DELEGATE_OneParam(FOnToggleStatePrefetch, ECheckBoxState);
 
 /**
  * 
@@ -31,6 +36,10 @@ DECLARE_DELEGATE_OneParam(FOnToggleCheckStateChanged, ECheckBoxState);
 class UMGEXTENTIONSAMPLE_API SMyToggle : public SPanel
 {
 public:
+	/**
+	 * The setters only store the value. Once the slot is added, changes must be followed by the matching
+	 * SMyToggle::InvalidateSlot* call, the toggle caches its layout, paint order and spatial index and doesn't poll its slots.
+	 */
     class FSlot : public TSlotBase<FSlot>
     {
     public:
@@ -46,11 +55,17 @@ public:
 		/** Auto-Size */
 		TAttribute<bool> AutoSizeAttr;
 
-		/** Z-Order */
+		/** The order priority the slot is painted and hit tested in. Higher values are drawn last, on top of the others */
 		TAttribute<float> ZOrderAttr;
 
-		/** StateBelonged */
+		/** StateBelonged, set it through SlotType() so the cached state mask follows */
         TAttribute<EToggleSlotType> SlotTypeAttr;
+
+		/** States shown in when SlotType is Masked, see EToggleStateFlags. Set it through StateMask() so the cached state mask follows */
+		TAttribute<uint8> StateMaskAttr;
+
+		/** Smallest on-screen size, in pixels of the toggle's shorter side, the slot is still drawn at. 0 always draws it */
+		TAttribute<float> MinDrawSizeAttr;
         
 		FSlot()
 			: TSlotBase<FSlot>()
@@ -60,7 +75,10 @@ public:
 			, AutoSizeAttr(false)
 			, ZOrderAttr(0)
 			, SlotTypeAttr(EToggleSlotType::Other)
+			, StateMaskAttr((uint8)EToggleStateFlags::All)
+			, MinDrawSizeAttr(0.0f)
 		{
+			UpdateCachedStateMask();
 		}
 
 		FSlot& Offset(const TAttribute<FMargin>& InOffset)
@@ -102,42 +120,102 @@ public:
         FSlot& SlotType(const TAttribute<EToggleSlotType>& InSlotType)
         {
 			SlotTypeAttr = InSlotType;
+			UpdateCachedStateMask();
 			return *this;
         }
+
+		FSlot& StateMask(const TAttribute<uint8>& InStateMask)
+		{
+			StateMaskAttr = InStateMask;
+			UpdateCachedStateMask();
+			return *this;
+		}
+
+		FSlot& MinDrawSize(const TAttribute<float>& InMinDrawSize)
+		{
+			MinDrawSizeAttr = InMinDrawSize;
+			return *this;
+		}
+
+		/** The check states this slot is shown in, as EToggleStateFlags bits */
+		uint8 GetStateMask() const
+		{
+			if (SlotTypeAttr.IsBound() || StateMaskAttr.IsBound())
+			{
+				return ToggleSlotTypeToStateMask(SlotTypeAttr.Get(), StateMaskAttr.Get());
+			}
+			return CachedStateMask;
+		}
+
+	private:
+		void UpdateCachedStateMask()
+		{
+			CachedStateMask = ToggleSlotTypeToStateMask(SlotTypeAttr.Get(), StateMaskAttr.Get());
+		}
+
+		/** GetStateMask of unbound attributes, evaluated when they are set */
+		uint8 CachedStateMask;
     };
 public:
 	SMyToggle();
+	virtual ~SMyToggle();
     
     SLATE_BEGIN_ARGS(SMyToggle)
 		: _IsToggleChecked(ECheckBoxState::Unchecked)
 		, _IsFocusable(true)
+		, _OptimisticUpdate(false)
+		, _OptimisticTimeout(1.0f)
+		, _MenuContentKey(NAME_None)
+		, _PrebuildMenuOnHover(false)
     {
     }
     SLATE_SUPPORTS_SLOT(SMyToggle::FSlot)
 	SLATE_ATTRIBUTE(ECheckBoxState, IsToggleChecked)
 	SLATE_ARGUMENT(bool, IsFocusable)
+	/** When IsToggleChecked is bound, show the new state on click without waiting for the binding to report it */
+	SLATE_ARGUMENT(bool, OptimisticUpdate)
+	/** Seconds the binding has to change before an optimistic state is rolled back */
+	SLATE_ARGUMENT(float, OptimisticTimeout)
 	SLATE_ATTRIBUTE(EButtonClickMethod::Type, ClickMethod)
 	SLATE_EVENT(FOnToggleCheckStateChanged, OnToggleCheckStateChanged)
+	/** Called on hover and keyboard focus with the state a click would switch to, to get its resources ready. Opt-in, nothing is prefetched while unbound */
+	SLATE_EVENT(FOnToggleStatePrefetch, OnPrefetchState)
 	SLATE_EVENT(FOnGetContent, OnGetMenuContent)
+	/** Toggles with the same key share one cached OnGetMenuContent menu, see FMyToggleMenuCache. None builds a new menu on every right click */
+	SLATE_ARGUMENT(FName, MenuContentKey)
+	/** Builds the cached menu in a coming frame when the toggle is hovered, so it opens without building */
+	SLATE_ARGUMENT(bool, PrebuildMenuOnHover)
+	/** Directional navigation between the toggles sharing the grid, instead of Slate's search */
+	SLATE_ARGUMENT(TSharedPtr<FMyToggleNavigationGrid>, NavigationGrid)
     SLATE_END_ARGS()
     
     void Construct(const FArguments& InArgs);
     static FSlot& Slot()
     {
-        return *(new FSlot());
+        return *FToggleChildren::AllocateSlot();
     }
     
     FSlot& AddSlot()
     {
         Invalidate(EInvalidateWidget::Layout);
-        SMyToggle::FSlot& slot = *(new FSlot());
+        SMyToggle::FSlot& slot = *this->Children.AllocatePooledSlot();
         this->Children.Add(&slot);
+        bSlotOrderDirty = true;
+        bSpatialIndexDirty = true;
         return slot;
     }
 
+	/** Allocates room for NumSlots more AddSlot calls at once, so they share one block. */
+	void ReserveSlots(int32 NumSlots)
+	{
+		Children.ReservePooled(NumSlots);
+	}
+
 	void SetToggleIsChecked(TAttribute<ECheckBoxState> InIsToggleChecked);
     
     int32 RemoveSlot(const TSharedRef<SWidget>& SlotWidget);
+	/** Removes a slot by identity, also works for slots showing a placeholder or the shared null widget. */
+	int32 RemoveSlot(const FSlot* SlotToRemove);
     void ClearChildren();
 
 	bool IsPressed() const
@@ -146,6 +224,71 @@ public:
 	}
 
 	void ToggleCheckedState();
+
+	/** The state shown: the predicted one while an optimistic update is pending, the IsToggleChecked value otherwise. */
+	ECheckBoxState GetCheckedState() const;
+
+	/** The state ToggleCheckedState would switch to. */
+	ECheckBoxState GetNextCheckedState() const;
+
+	void SetMenuContentKey(FName InMenuContentKey)
+	{
+		MenuContentKey = InMenuContentKey;
+	}
+
+	/** Leaves the current navigation grid and joins InNavigationGrid, if any. */
+	void SetNavigationGrid(const TSharedPtr<FMyToggleNavigationGrid>& InNavigationGrid);
+
+	// Slot change notifications. Each raises the smallest invalidation that keeps the toggle correct,
+	// slots that aren't shown in the current state don't invalidate anything.
+
+	/** The slot's z-order changed: rebuilds the cached paint order and repaints. */
+	void InvalidateSlotOrder();
+	/** The states the slot is shown in changed: re-layout if it (dis)appears from the current state. */
+	void InvalidateSlotStates(const FSlot& Slot, uint8 OldStateMask);
+	/** The slot's desired size contribution changed, e.g. size to content was toggled. */
+	void InvalidateSlotDesiredSize(const FSlot& Slot);
+	/**
+	 * The slot's arranged geometry changed without affecting the toggle's desired size, e.g. its alignment.
+	 * Slate in this engine version has no per-child invalidation, the smallest unit is a Paint invalidation of the whole toggle.
+	 */
+	void InvalidateSlotGeometry(const FSlot& Slot);
+	/** The slot's offset changed: repaint the toggle, see InvalidateSlotGeometry, or re-layout if the desired size is affected. */
+	void InvalidateSlotOffset(const FSlot& Slot, const FMargin& OldOffset);
+
+	int32 NumSlots() const
+	{
+		return Children.Num();
+	}
+
+	const FSlot& GetSlot(int32 SlotIndex) const
+	{
+		return Children[SlotIndex];
+	}
+
+	/** Whether the slot belongs to the state currently shown. */
+	bool IsSlotShown(const FSlot& Slot) const
+	{
+		return IsSameWithCheckState(Slot);
+	}
+
+	/** Bytes held by the slots, including the payloads of bound slot attributes and the arrangement kept for paint. */
+	SIZE_T GetSlotStorageSize() const;
+
+	/**
+	 * Children drawn at a screen position, top-most first, found through the spatial index of the shown state.
+	 * Slate's own hit-testing goes through FHittestGrid, this is for queries of the toggle's users.
+	 */
+	void FindChildrenAtPosition(const FGeometry& AllottedGeometry, const FVector2D& AbsolutePosition, TArray<int32>& OutChildIndices) const;
+
+	/** The geometry the slot's child is arranged at, without arranging the other children. False if it isn't drawn. */
+	bool FindChildGeometry(const FGeometry& AllottedGeometry, const FSlot& Slot, FGeometry& OutGeometry) const;
+
+	/** Whether the toggle was painted in this or the previous frame, i.e. is on screen. */
+	bool WasPaintedRecently() const
+	{
+		return LastPaintFrame + 1 >= GFrameCounter;
+	}
 public:
       // Begin SWidget overrides
     virtual void OnArrangeChildren( const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren ) const override;
@@ -162,28 +305,119 @@ public:
 	virtual FReply OnMouseButtonUp(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
 	virtual void OnMouseEnter(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent) override;
 	virtual void OnMouseLeave(const FPointerEvent& MouseEvent) override;
+	virtual FReply OnFocusReceived(const FGeometry& MyGeometry, const FFocusEvent& InFocusEvent) override;
+	virtual FNavigationReply OnNavigation(const FGeometry& MyGeometry, const FNavigationEvent& InNavigationEvent) override;
 	virtual bool IsInteractable() const override;
     // End SWidget overrides
 protected:
     // Begin SWidget overrides.
     virtual FVector2D ComputeDesiredSize(float) const override;
+	virtual bool CustomPrepass(float LayoutScaleMultiplier) override;
     // End SWidget overrides.
 private:
-	typedef TArray<bool, TInlineAllocator<16>> FArrangedChildLayers;
+	/** Layer flags are inline up to a typical child count. Not on the mem stack, OnPaint keeps them across the children's paint. */
+	typedef TArray<bool, TInlineAllocator<32>> FArrangedChildLayers;
 
+	void RebuildSlotOrder() const;
 	void ArrangeLayeredChildren(const FGeometry& AllottedGeometry, FArrangedChildren& ArrangedChildren, FArrangedChildLayers& ArrangedChildLayers) const;
-	bool IsSameWithCheckState(const EToggleSlotType& SlotType) const;
+	bool IsSameWithCheckState(const FSlot& Slot) const;
+
+	/** Rebuilds the spatial index if the layout, the state or the size changed since it was built. */
+	void UpdateSpatialIndex(const FGeometry& AllottedGeometry) const;
+
+	/** Shows a state set by the user: directly when unbound, as a prediction in optimistic update mode. */
+	void ShowNewCheckedState(ECheckBoxState NewState);
+	EActiveTimerReturnType HandlePredictionTimeout(double InCurrentTime, float InDeltaTime, uint32 InPredictionSerial);
+
+	/**
+	 * Runs OnPrefetchState for the next state and prepasses the children only that state shows.
+	 * Skipped if the same state was prefetched within half the resident time, hovering back and forth is free.
+	 */
+	void PrefetchNextState();
+
+	/** Mouse down and double click behaviour, without input recording. */
+	FReply HandleMouseButtonDown(const FGeometry& MyGeometry, const FPointerEvent& MouseEvent);
+
+	/** Latency tracking, see FMyToggleLatencyTracker. */
+	void BeginLatencySample();
+	void FinishLatencyBroadcast(ECheckBoxState NewState);
+	void FinishLatencyPaint() const;
 protected:
-    TPanelChildren<FSlot> Children;
+	/** Slots are pooled in contiguous blocks rather than allocated one by one. */
+	typedef TMyTogglePanelChildren<FSlot> FToggleChildren;
+
+    FToggleChildren Children;
 
 	TAttribute<ECheckBoxState> IsToggleChecked;
 
 	FOnToggleCheckStateChanged OnToggleCheckStateChanged;
+	FOnToggleStatePrefetch OnPrefetchState;
+	/** Last prefetch, see PrefetchNextState. */
+	ECheckBoxState LastPrefetchedState;
+	double LastPrefetchTime;
 	FOnGetContent OnGetMenuContent;
+	FName MenuContentKey;
+	bool bPrebuildMenuOnHover;
+
+	TSharedPtr<FMyToggleNavigationGrid> NavigationGrid;
 	
 	EButtonClickMethod::Type ClickMethod;
 
 
 	bool bIsFocusable;
 	bool bIsPressed;
+
+private:
+	/**
+	 * Scratch arrangement reused by OnPaint so steady-state frames don't reallocate it. Emptied after every paint but
+	 * keeps its capacity, about sizeof(FArrangedWidget) per child shown in the widest state painted so far, for the
+	 * toggle's lifetime. Counted in GetSlotStorageSize.
+	 */
+	mutable FArrangedChildren PaintArrangedChildren;
+
+	/** GFrameCounter of the last paint. */
+	mutable uint64 LastPaintFrame;
+
+public:
+	struct FChildZOrder
+	{
+		int32 ChildIndex;
+		float ZOrder;
+	};
+
+private:
+	/** All children sorted by z-order, rebuilt when InvalidateSlotOrder is called or children are added or removed. */
+	mutable TArray<FChildZOrder> CachedSlotOrder;
+	mutable bool bSlotOrderDirty;
+	/** A bound z-order attribute can change any frame, so the order is re-sorted on every arrange. */
+	mutable bool bHasBoundZOrder;
+
+	/** Local rects of the shown state's children, rebuilt after the slot invalidations above. */
+	mutable FMyToggleSpatialIndex SpatialIndex;
+	mutable bool bSpatialIndexDirty;
+	/** Children size to content or have bound layout attributes: their rects may change without notice. */
+	mutable bool bSpatialIndexVolatile;
+	mutable ECheckBoxState SpatialIndexState;
+	mutable FVector2D SpatialIndexSize;
+
+	/** Child index of every slot for FindChildGeometry. Entries are checked against Children and it's rebuilt on a miss. */
+	mutable TMap<const FSlot*, int32> ChildIndexBySlot;
+
+	bool bOptimisticUpdate;
+	float OptimisticTimeout;
+
+	/** Optimistic update in flight, cleared by GetCheckedState as soon as the bound value moves away from PredictionBaseState. */
+	mutable bool bHasPrediction;
+	ECheckBoxState PredictedState;
+	ECheckBoxState PredictionBaseState;
+	/** Tells the timeout of the current prediction apart from those of earlier ones. */
+	uint32 PredictionSerial;
+	TWeakPtr<FActiveTimerHandle> PredictionTimer;
+
+	/** FPlatformTime::Seconds of the input being measured, 0 when latency tracking is off. */
+	double LatencyInputTime;
+	/** Input time of the click whose first paint is awaited. */
+	double LatencyPaintInputTime;
+	mutable bool bLatencyPaintPending;
+	ECheckBoxState LatencyExpectedState;
 };
@@ -16,4 +16,40 @@ enum class EToggleSlotType : uint8
 	Undetermined,
 	/** Neither checked nor unchecked */
 	Other,
-};
\ No newline at end of file
+	/** Shown in every state selected by the slot's state mask */
+	Masked,
+};
+
+UENUM(BlueprintType, meta = (Bitflags, UseEnumValuesAsMaskValuesInEditor = "true"))
+enum class EToggleStateFlags : uint8
+{
+	None = 0 UMETA(Hidden),
+	/** Unchecked */
+	Unchecked = 1 << 0,
+	/** Checked */
+	Checked = 1 << 1,
+	/** Neither checked nor unchecked */
+	Undetermined = 1 << 2,
+	All = Unchecked | Checked | Undetermined UMETA(Hidden),
+};
+ENUM_CLASS_FLAGS(EToggleStateFlags)
+
+/** Bit of a check state inside a state mask, the state is an ECheckBoxState value. */
+FORCEINLINE uint8 ToggleStateToMask(uint8 CheckState)
+{
+	return (uint8)(1 << CheckState);
+}
+
+/** Resolves the states a slot is shown in to a mask, so visibility tests are a single AND. */
+FORCEINLINE uint8 ToggleSlotTypeToStateMask(EToggleSlotType SlotType, uint8 CustomMask)
+{
+	switch (SlotType)
+	{
+	case EToggleSlotType::Other:
+		return (uint8)EToggleStateFlags::All;
+	case EToggleSlotType::Masked:
+		return CustomMask & (uint8)EToggleStateFlags::All;
+	default:
+		return ToggleStateToMask((uint8)SlotType);
+	}
+}
\ No newline at end of file